@@ -0,0 +1,68 @@
+#include <glad/glad.h>
+
+#include "background.h"
+#include "gl_state.h"
+#include "instrument.h"
+#include "vertex_format.h"
+
+static BackgroundMode background_mode;
+static GLuint background_program;
+static GLuint background_texture;
+static GLuint vao, vbo;
+
+static GLint time_loc = -1;
+static GLint resolution_loc = -1;
+static int background_width, background_height;
+
+void background_init(BackgroundMode mode, GLuint program, GLuint texture, int width, int height) {
+    background_mode = mode;
+    background_program = program;
+    background_texture = texture;
+
+    if (mode == BACKGROUND_STARFIELD) {
+        time_loc = glGetUniformLocation(program, "time");
+        resolution_loc = glGetUniformLocation(program, "resolution");
+    }
+
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+
+    gl_state_bind_vao(vao);
+    gl_state_bind_buffer(GL_ARRAY_BUFFER, vbo);
+
+    vertex_format_sprite_layout();
+
+    // Positions are encoded relative to the world size (vertex_format.h),
+    // so the quad is the same at every size and is uploaded only once.
+    GLshort right = vertex_position(width, width), top = vertex_position(height, height);
+    SpriteVertex vertices[] = {
+        { 0, 0, 0, 65535 },
+        { right, 0, 65535, 65535 },
+        { 0, top, 0, 0 },
+        { right, top, 65535, 0 },
+    };
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    background_resize(width, height);
+}
+
+void background_resize(int width, int height) {
+    background_width = width;
+    background_height = height;
+}
+
+void background_draw(float time) {
+    INSTRUMENT_SCOPE("background_draw");
+    gl_state_blend(0);
+    gl_state_use_program(background_program);
+
+    if (background_mode == BACKGROUND_STARFIELD) {
+        glUniform1f(time_loc, time);
+        glUniform2f(resolution_loc, background_width, background_height);
+    } else {
+        gl_state_bind_texture(background_texture);
+    }
+
+    gl_state_bind_vao(vao);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
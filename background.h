@@ -0,0 +1,24 @@
+#ifndef BACKGROUND_H
+#define BACKGROUND_H
+
+#include <glad/glad.h>
+
+// Full-screen backdrop. The quad lives in its own VAO/VBO for the whole
+// run and never needs rebuilding, not even on resize. Both modes are
+// opaque, so the backdrop is drawn with blending off.
+//
+// BACKGROUND_TEXTURE samples bg.png with the sprite program.
+// BACKGROUND_STARFIELD draws parallax star layers entirely in
+// starfield_fragment.glsl and needs no texture at all.
+
+typedef enum {
+    BACKGROUND_TEXTURE,
+    BACKGROUND_STARFIELD,
+} BackgroundMode;
+
+// texture is ignored in BACKGROUND_STARFIELD mode.
+void background_init(BackgroundMode mode, GLuint program, GLuint texture, int width, int height);
+void background_resize(int width, int height);
+void background_draw(float time);
+
+#endif
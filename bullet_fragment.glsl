@@ -0,0 +1,15 @@
+#version 330 core
+
+flat in float Layer;
+
+out vec4 FragColor;
+
+uniform sampler2DArray sprites;
+
+void main() {
+    // gl_PointCoord starts at the top-left, which matches the image rows.
+    vec4 color = texture(sprites, vec3(gl_PointCoord, Layer));
+    if (color.a == 0.0)
+        discard;
+    FragColor = color;
+}
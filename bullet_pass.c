@@ -0,0 +1,156 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glad/glad.h>
+
+#include "bullet_pass.h"
+#include "frame_pipeline.h"
+#include "gl_state.h"
+#include "instrument.h"
+#include "render_target.h"
+#include "stb_image.h"
+#include "vertex_format.h"
+
+#define MAX_LAYERS 8
+#define MAX_POINTS 4096
+
+// 8 bytes per bullet; the layer is a plain integer the shader reads as float.
+typedef struct {
+    GLshort x, y;
+    GLushort layer, padding;
+} BulletPoint;
+
+BulletMode bullet_mode = BULLETS_QUADS;
+
+static GLuint bullet_program;
+static GLint point_size_loc;
+static GLuint vaos[MAX_FRAMES_IN_FLIGHT], vbos[MAX_FRAMES_IN_FLIGHT];
+static GLuint texture_array;
+static int layer_width, layer_height;
+
+static struct {
+    char path[64];
+    GLuint texture;
+} layers[MAX_LAYERS];
+static int num_layers = 0;
+
+static BulletPoint points[MAX_POINTS];
+static int num_points = 0;
+static float world_width, world_height;
+
+void bullet_pass_init(GLuint program) {
+    bullet_program = program;
+    point_size_loc = glGetUniformLocation(program, "point_size");
+
+    // One buffer per frame slot, sized for the most points a frame can
+    // have, so a frame still on the GPU is never overwritten.
+    glGenVertexArrays(MAX_FRAMES_IN_FLIGHT, vaos);
+    glGenBuffers(MAX_FRAMES_IN_FLIGHT, vbos);
+
+    for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+        gl_state_bind_vao(vaos[i]);
+        gl_state_bind_buffer(GL_ARRAY_BUFFER, vbos[i]);
+        glBufferData(GL_ARRAY_BUFFER, MAX_POINTS * sizeof(BulletPoint), NULL, GL_STREAM_DRAW);
+
+        glVertexAttribPointer(0, 2, GL_SHORT, GL_TRUE, sizeof(BulletPoint), (void*)offsetof(BulletPoint, x));
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 1, GL_UNSIGNED_SHORT, GL_FALSE, sizeof(BulletPoint), (void*)offsetof(BulletPoint, layer));
+        glEnableVertexAttribArray(1);
+    }
+
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    glGenTextures(1, &texture_array);
+}
+
+void bullet_pass_register(GLuint texture, const char *path) {
+    if (bullet_mode != BULLETS_POINTS)
+        return;
+
+    for (int i = 0; i < num_layers; ++i) {
+        if (strcmp(layers[i].path, path) == 0) {
+            layers[i].texture = texture;
+            return;
+        }
+    }
+
+    if (num_layers == MAX_LAYERS) {
+        printf("[ERROR] Too many bullet sprites, %s is drawn as quads\n", path);
+        return;
+    }
+
+    int width, height, components;
+    unsigned char *data = stbi_load(path, &width, &height, &components, 4);
+    if (!data) {
+        printf("Texture failed to load at path: %s\n", path);
+        return;
+    }
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture_array);
+    if (num_layers == 0) {
+        layer_width = width;
+        layer_height = height;
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, width, height, MAX_LAYERS, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+
+    if (width != layer_width || height != layer_height) {
+        printf("[ERROR] Bullet sprite %s is %dx%d, expected %dx%d\n", path, width, height, layer_width, layer_height);
+    } else {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, num_layers, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, data);
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+        snprintf(layers[num_layers].path, sizeof(layers[num_layers].path), "%s", path);
+        layers[num_layers].texture = texture;
+        ++num_layers;
+    }
+
+    stbi_image_free(data);
+}
+
+void bullet_pass_begin(float width, float height) {
+    world_width = width;
+    world_height = height;
+    num_points = 0;
+}
+
+int bullet_pass_layer(GLuint texture) {
+    for (int i = 0; i < num_layers; ++i)
+        if (layers[i].texture == texture)
+            return i;
+    return -1;
+}
+
+void bullet_pass_add(GLuint texture, float x, float y) {
+    int layer = bullet_pass_layer(texture);
+    if (layer < 0 || num_points == MAX_POINTS)
+        return;
+
+    points[num_points++] = (BulletPoint){
+        vertex_position(x, world_width), vertex_position(y, world_height), (GLushort)layer, 0
+    };
+}
+
+void bullet_pass_draw(float size) {
+    INSTRUMENT_SCOPE("bullet_pass_draw");
+    INSTRUMENT_GAUGE("bullet_points", num_points);
+    if (num_points == 0)
+        return;
+
+    int viewport_width, viewport_height;
+    render_target_viewport(&viewport_width, &viewport_height);
+
+    gl_state_use_program(bullet_program);
+    glUniform1f(point_size_loc, size * viewport_height / world_height);
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture_array);
+    int slot = frame_pipeline_slot();
+    gl_state_bind_vao(vaos[slot]);
+    gl_state_bind_buffer(GL_ARRAY_BUFFER, vbos[slot]);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, num_points * sizeof(BulletPoint), points);
+    glDrawArrays(GL_POINTS, 0, num_points);
+}
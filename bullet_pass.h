@@ -0,0 +1,41 @@
+#ifndef BULLET_PASS_H
+#define BULLET_PASS_H
+
+#include <glad/glad.h>
+
+// Dedicated bullet pass. Instead of a whole sprite outline per bullet it
+// uploads one 8-byte point (x, y, sprite layer) and the vertex shader expands it
+// with gl_PointSize; the fragment shader samples the bullet sprites from a
+// texture array through gl_PointCoord. All bullets go out in one draw.
+//
+// A point rasterizes its whole square, so it gives up the fill savings of
+// the bullet hull meshes (sprite_mesh.h) for less vertex data. Quads are
+// the default; --bullets=points opts in.
+
+typedef enum {
+    BULLETS_QUADS,
+    BULLETS_POINTS,
+} BulletMode;
+
+extern BulletMode bullet_mode;
+
+void bullet_pass_init(GLuint program);
+
+// Adds a bullet sprite to the texture array and remembers which layer the
+// texture maps to. Calling it again for the same path (after a restart)
+// only updates the texture it maps from.
+void bullet_pass_register(GLuint texture, const char *path);
+
+// The texture array layer texture was registered at, or -1 if it was not
+// (or the pass is off); such bullets have to be drawn as quads.
+int bullet_pass_layer(GLuint texture);
+
+// width and height are the size of the visible world, used to encode the
+// positions added until the next begin and to convert sizes to pixels.
+void bullet_pass_begin(float width, float height);
+void bullet_pass_add(GLuint texture, float x, float y);
+
+// size is the bullet size in world units.
+void bullet_pass_draw(float size);
+
+#endif
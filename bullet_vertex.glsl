@@ -0,0 +1,15 @@
+#version 330 core
+
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in float aLayer;
+
+flat out float Layer;
+
+uniform mat4 transform;
+uniform float point_size;
+
+void main() {
+    gl_Position = transform * vec4(aPos, 0.0, 1.0);
+    gl_PointSize = point_size;
+    Layer = aLayer;
+}
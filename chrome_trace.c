@@ -0,0 +1,177 @@
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "chrome_trace.h"
+#include "timer.h"
+
+// Events are stored in chunks allocated on demand, so a short session only
+// pays for what it records. A thread that fills all of its chunks drops
+// further events and counts them.
+#define CHUNK_EVENTS 65536
+#define MAX_CHUNKS 64
+
+typedef struct {
+    uint64_t time_ns;
+    const char *name;
+    const char *detail;
+    char type;
+} TraceEvent;
+
+typedef struct TraceBuffer {
+    struct TraceBuffer *next;
+    int tid;
+    const char *thread_name;
+    TraceEvent *chunks[MAX_CHUNKS];
+    int count;
+    unsigned long long dropped;
+} TraceBuffer;
+
+int chrome_trace_enabled = 0;
+
+static _Atomic(TraceBuffer*) buffers = NULL;
+static atomic_int next_tid = 0;
+static __thread TraceBuffer *local = NULL;
+static const char *output_path = NULL;
+static uint64_t start_ns;
+
+static TraceBuffer *thread_buffer() {
+    if (local)
+        return local;
+
+    local = calloc(1, sizeof(TraceBuffer));
+    if (!local)
+        return NULL;
+    local->tid = atomic_fetch_add(&next_tid, 1) + 1;
+
+    TraceBuffer *head = atomic_load(&buffers);
+    do {
+        local->next = head;
+    } while (!atomic_compare_exchange_weak(&buffers, &head, local));
+
+    return local;
+}
+
+static void record(char type, const char *name, const char *detail) {
+    if (!chrome_trace_enabled)
+        return;
+
+    uint64_t now = timer_now_ns();
+    TraceBuffer *buffer = thread_buffer();
+    if (!buffer)
+        return;
+
+    int chunk = buffer->count / CHUNK_EVENTS;
+    if (chunk >= MAX_CHUNKS ||
+        (!buffer->chunks[chunk] && !(buffer->chunks[chunk] = malloc(CHUNK_EVENTS * sizeof(TraceEvent))))) {
+        ++buffer->dropped;
+        return;
+    }
+
+    TraceEvent *event = &buffer->chunks[chunk][buffer->count % CHUNK_EVENTS];
+    event->time_ns = now;
+    event->name = name;
+    event->detail = detail;
+    event->type = type;
+    ++buffer->count;
+}
+
+void chrome_trace_open(const char *path) {
+    output_path = path;
+    start_ns = timer_now_ns();
+    chrome_trace_enabled = 1;
+    chrome_trace_thread_name("main");
+}
+
+void chrome_trace_thread_name(const char *name) {
+    if (!chrome_trace_enabled)
+        return;
+
+    TraceBuffer *buffer = thread_buffer();
+    if (buffer)
+        buffer->thread_name = name;
+}
+
+void chrome_trace_begin(const char *name) {
+    record('B', name, NULL);
+}
+
+void chrome_trace_begin_detail(const char *name, const char *detail) {
+    record('B', name, detail);
+}
+
+void chrome_trace_end(const char *name) {
+    record('E', name, NULL);
+}
+
+static void write_string(FILE *file, const char *text) {
+    fputc('"', file);
+    for (; *text; ++text) {
+        if (*text == '"' || *text == '\\')
+            fputc('\\', file);
+        if ((unsigned char)*text >= 0x20)
+            fputc(*text, file);
+    }
+    fputc('"', file);
+}
+
+void chrome_trace_close() {
+    if (!chrome_trace_enabled)
+        return;
+    chrome_trace_enabled = 0;
+
+    FILE *file = fopen(output_path, "w");
+    if (!file)
+        printf("[ERROR] Failed to write trace: %s\n", output_path);
+
+    unsigned long long events = 0, dropped = 0;
+    int first = 1;
+    if (file)
+        fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    TraceBuffer *buffer = atomic_exchange(&buffers, NULL);
+    while (buffer) {
+        if (file && buffer->thread_name) {
+            fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+                    first ? "" : ",\n", buffer->tid);
+            write_string(file, buffer->thread_name);
+            fprintf(file, "}}");
+            first = 0;
+        }
+
+        for (int i = 0; file && i < buffer->count; ++i) {
+            const TraceEvent *event = &buffer->chunks[i / CHUNK_EVENTS][i % CHUNK_EVENTS];
+            fprintf(file, "%s{\"name\":", first ? "" : ",\n");
+            write_string(file, event->name);
+            fprintf(file, ",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d",
+                    event->type, (event->time_ns - start_ns) / 1e3, buffer->tid);
+            if (event->detail) {
+                fprintf(file, ",\"args\":{\"detail\":");
+                write_string(file, event->detail);
+                fputc('}', file);
+            }
+            fputc('}', file);
+            first = 0;
+        }
+
+        events += buffer->count;
+        dropped += buffer->dropped;
+
+        TraceBuffer *next = buffer->next;
+        for (int i = 0; i < MAX_CHUNKS; ++i)
+            free(buffer->chunks[i]);
+        free(buffer);
+        buffer = next;
+    }
+    local = NULL;
+
+    if (file) {
+        fprintf(file, "\n]}\n");
+        fclose(file);
+        printf("[TRACE] %llu events written to %s", events, output_path);
+        if (dropped)
+            printf(" (%llu dropped, buffers full)", dropped);
+        printf("\n");
+    }
+}
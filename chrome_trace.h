@@ -0,0 +1,25 @@
+#ifndef CHROME_TRACE_H
+#define CHROME_TRACE_H
+
+// Opt-in timeline of begin/end events in the Chrome trace-event JSON
+// format, which chrome://tracing and ui.perfetto.dev open directly.
+//
+// Each thread appends to its own buffer, so recording never takes a lock;
+// buffers are linked into a global list with a compare-and-swap the first
+// time a thread records. The file is written by chrome_trace_close, after
+// every other recording thread has been joined. Names and details must
+// outlive the trace (literals, asset paths).
+
+extern int chrome_trace_enabled;
+
+void chrome_trace_open(const char *path);
+void chrome_trace_close();
+
+// Names the calling thread in the viewer.
+void chrome_trace_thread_name(const char *name);
+
+void chrome_trace_begin(const char *name);
+void chrome_trace_begin_detail(const char *name, const char *detail);
+void chrome_trace_end(const char *name);
+
+#endif
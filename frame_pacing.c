@@ -0,0 +1,184 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <GLFW/glfw3.h>
+
+#include "frame_pacing.h"
+#include "timer.h"
+
+// The limiter sleeps until this long before the deadline and spins for
+// the rest, which absorbs the scheduler's wake-up jitter.
+#define SPIN_MARGIN_NS 1500000ull
+
+// 0.1 ms buckets up to 100 ms; longer frames go into the last one.
+#define BUCKET_MS 0.1
+#define NUM_BUCKETS 1000
+
+PacingMode pacing_mode = PACING_VSYNC;
+double pacing_target_fps = 60.0;
+
+static uint64_t deadline = 0;
+static uint64_t last_present = 0;
+
+static unsigned histogram[NUM_BUCKETS];
+static double overflow_total_ms = 0.0;
+static unsigned long long intervals = 0;
+static double interval_total_ms = 0.0;
+
+int frame_pacing_parse(const char *value) {
+    if (strcmp(value, "vsync") == 0) {
+        pacing_mode = PACING_VSYNC;
+    } else if (strcmp(value, "adaptive") == 0) {
+        pacing_mode = PACING_ADAPTIVE;
+    } else if (strcmp(value, "uncapped") == 0) {
+        pacing_mode = PACING_UNCAPPED;
+    } else if (strncmp(value, "cap", 3) == 0 && (value[3] == '\0' || value[3] == ':')) {
+        pacing_mode = PACING_CAP;
+        if (value[3] == ':')
+            pacing_target_fps = atof(value + 4);
+        if (pacing_target_fps <= 0.0)
+            return 0;
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+void frame_pacing_init() {
+    int interval = 1;
+    if (pacing_mode == PACING_ADAPTIVE) {
+        if (glfwExtensionSupported("GLX_EXT_swap_control_tear") ||
+            glfwExtensionSupported("WGL_EXT_swap_control_tear")) {
+            interval = -1;
+        } else {
+            printf("[INFO] Adaptive vsync not supported, using vsync\n");
+        }
+    } else if (pacing_mode == PACING_UNCAPPED || pacing_mode == PACING_CAP) {
+        interval = 0;
+    }
+
+    glfwSwapInterval(interval);
+}
+
+static void sleep_until(uint64_t time_ns) {
+    struct timespec ts = { (time_t)(time_ns / 1000000000ull), (long)(time_ns % 1000000000ull) };
+    // Only a signal is worth retrying; on any other error the spin in
+    // frame_pacing_wait covers the rest.
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+        ;
+}
+
+void frame_pacing_wait() {
+    if (pacing_mode != PACING_CAP)
+        return;
+
+    uint64_t period = (uint64_t)(1e9 / pacing_target_fps);
+    uint64_t now = timer_now_ns();
+
+    // First frame, or more than a frame behind: don't try to catch up with
+    // a burst of frames. This one is already late; restart the schedule so
+    // the next one is a full period after it.
+    if (!deadline || now > deadline + period) {
+        deadline = now + period;
+        return;
+    }
+
+    if (deadline > now + SPIN_MARGIN_NS)
+        sleep_until(deadline - SPIN_MARGIN_NS);
+    while (timer_now_ns() < deadline)
+        ;
+
+    deadline += period;
+}
+
+void frame_pacing_presented() {
+    uint64_t now = timer_now_ns();
+    if (last_present) {
+        double interval = (now - last_present) / 1e6;
+        int bucket = (int)(interval / BUCKET_MS);
+        if (bucket >= NUM_BUCKETS) {
+            bucket = NUM_BUCKETS - 1;
+            overflow_total_ms += interval;
+        }
+
+        ++histogram[bucket];
+        ++intervals;
+        interval_total_ms += interval;
+    }
+    last_present = now;
+}
+
+void frame_pacing_reset() {
+    last_present = 0;
+    deadline = 0;
+}
+
+static double bucket_ms(int bucket) {
+    return (bucket + 0.5) * BUCKET_MS;
+}
+
+void frame_pacing_report() {
+    if (intervals == 0)
+        return;
+
+    static const char *names[] = { "vsync", "adaptive", "uncapped", "cap" };
+    printf("[PACING] %s", names[pacing_mode]);
+    if (pacing_mode == PACING_CAP)
+        printf(" %.1f fps", pacing_target_fps);
+    printf(": %llu frames, %.1f fps average\n", intervals, intervals * 1000.0 / interval_total_ms);
+
+    // Median, and the average of the slowest 1% of frames (walking the
+    // histogram down from the top).
+    unsigned long long seen = 0;
+    double median = 0.0;
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+        seen += histogram[i];
+        if (seen * 2 >= intervals) {
+            median = bucket_ms(i);
+            break;
+        }
+    }
+
+    unsigned long long worst = intervals / 100 ? intervals / 100 : 1;
+    unsigned long long taken = 0;
+    double worst_total = 0.0;
+    for (int i = NUM_BUCKETS - 1; i >= 0 && taken < worst; --i) {
+        unsigned long long n = histogram[i];
+        if (n > worst - taken)
+            n = worst - taken;
+        double ms = i == NUM_BUCKETS - 1 && histogram[i] ? overflow_total_ms / histogram[i] : bucket_ms(i);
+        worst_total += n * ms;
+        taken += n;
+    }
+
+    unsigned long long stutters = 0;
+    for (int i = 0; i < NUM_BUCKETS; ++i)
+        if (bucket_ms(i) > 2.0 * median)
+            stutters += histogram[i];
+
+    printf("[PACING] median %.2f ms, 1%% low %.1f fps, %llu stutters (> %.2f ms)\n",
+           median, 1000.0 / (worst_total / taken), stutters, 2.0 * median);
+
+    // Histogram in 1 ms rows, empty rows skipped.
+    unsigned max_row = 0;
+    unsigned rows[NUM_BUCKETS / 10] = { 0 };
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+        rows[i / 10] += histogram[i];
+        if (rows[i / 10] > max_row)
+            max_row = rows[i / 10];
+    }
+
+    for (int row = 0; row < NUM_BUCKETS / 10; ++row) {
+        if (!rows[row])
+            continue;
+
+        char bar[41];
+        int length = (int)(40.0 * rows[row] / max_row);
+        memset(bar, '#', length);
+        bar[length] = '\0';
+        printf("[PACING] %3d%s ms %8u %s\n", row, row == NUM_BUCKETS / 10 - 1 ? "+" : " ", rows[row], bar);
+    }
+}
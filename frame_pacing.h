@@ -0,0 +1,49 @@
+#ifndef FRAME_PACING_H
+#define FRAME_PACING_H
+
+// Frame pacing. The swap interval is set explicitly instead of inheriting
+// the driver default:
+//
+//   vsync     swap interval 1
+//   adaptive  swap interval -1 (late frames tear instead of waiting a
+//             whole refresh); falls back to vsync without
+//             EXT_swap_control_tear
+//   uncapped  swap interval 0
+//   cap       swap interval 0 plus a limiter that sleeps until shortly
+//             before the frame deadline and spins for the rest, so frames
+//             are spaced precisely at the target rate
+//
+// Every presented frame's interval goes into a histogram. On exit it is
+// printed with the average rate, the 1% low and the number of stutters
+// (frames that took more than twice the median interval).
+
+typedef enum {
+    PACING_VSYNC,
+    PACING_ADAPTIVE,
+    PACING_UNCAPPED,
+    PACING_CAP,
+} PacingMode;
+
+extern PacingMode pacing_mode;
+extern double pacing_target_fps;
+
+// Parses "vsync", "adaptive", "uncapped", "cap" or "cap:FPS". Returns 0 on
+// an unknown mode.
+int frame_pacing_parse(const char *value);
+
+// Applies the swap interval; needs a current context.
+void frame_pacing_init();
+
+// Call right before glfwSwapBuffers; sleeps in cap mode.
+void frame_pacing_wait();
+
+// Call right after glfwSwapBuffers returns.
+void frame_pacing_presented();
+
+// The loop stopped presenting for a while (idle mode); the next interval
+// is not a frame interval and the limiter starts over.
+void frame_pacing_reset();
+
+void frame_pacing_report();
+
+#endif
@@ -0,0 +1,54 @@
+#include <stddef.h>
+#include <stdio.h>
+
+#include <glad/glad.h>
+
+#include "frame_pipeline.h"
+
+// A slot is only reused once the GPU is done with it. Waits are cut into
+// pieces this long so a stuck GPU is reported while the CPU keeps waiting.
+#define FENCE_TIMEOUT_NS 1000000000ull
+
+int frames_in_flight = 1;
+
+static GLsync fences[MAX_FRAMES_IN_FLIGHT];
+static int slot = -1;
+
+int frame_pipeline_begin() {
+    slot = (slot + 1) % frames_in_flight;
+
+    if (fences[slot]) {
+        GLenum result;
+        while ((result = glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT_NS)) ==
+               GL_TIMEOUT_EXPIRED)
+            printf("[ERROR] GPU has not finished frame slot %d after %.0f ms, still waiting\n",
+                   slot, FENCE_TIMEOUT_NS / 1e6);
+
+        if (result == GL_WAIT_FAILED) {
+            printf("[ERROR] Waiting for frame slot %d failed, finishing all GPU work instead\n", slot);
+            glFinish();
+        }
+        glDeleteSync(fences[slot]);
+        fences[slot] = NULL;
+    }
+
+    return slot;
+}
+
+void frame_pipeline_end() {
+    fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+}
+
+int frame_pipeline_slot() {
+    return slot < 0 ? 0 : slot;
+}
+
+void frame_pipeline_shutdown() {
+    for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+        if (fences[i]) {
+            glDeleteSync(fences[i]);
+            fences[i] = NULL;
+        }
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef FRAME_PIPELINE_H
+#define FRAME_PIPELINE_H
+
+// Frame pipelining. Per-frame GPU resources (the sprite and bullet vertex
+// buffers) come in MAX_FRAMES_IN_FLIGHT slots. Every submitted frame is
+// fenced, and before a slot is recorded into again the CPU waits for the
+// frame that last used it, so at most frames_in_flight frames are queued
+// on the GPU and buffers are rewritten without implicit driver syncs.
+//
+// With frames_in_flight above 1 the main loop also submits the frame that
+// was simulated last, flushes it and only then simulates the next one,
+// so the CPU works while the GPU renders. Every extra frame in flight
+// adds up to one frame of latency, so the default is 1 and
+// --frames-in-flight=2 trades that latency for throughput.
+
+#define MAX_FRAMES_IN_FLIGHT 4
+
+extern int frames_in_flight;
+
+// Waits until the next slot is no longer used by the GPU and makes it the
+// current one. Returns the slot.
+int frame_pipeline_begin();
+
+// Fences everything submitted since frame_pipeline_begin and flushes it
+// to the GPU.
+void frame_pipeline_end();
+
+int frame_pipeline_slot();
+
+void frame_pipeline_shutdown();
+
+#endif
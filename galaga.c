@@ -2,6 +2,7 @@
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <math.h>
 
@@ -17,14 +18,39 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
+#include "background.h"
+#include "bullet_pass.h"
+#include "chrome_trace.h"
+#include "gl_loader.h"
+#include "gl_stats.h"
+#include "frame_pacing.h"
+#include "frame_pipeline.h"
+#include "gl_state.h"
+#include "hitch.h"
+#include "input.h"
+#include "instrument.h"
+#include "latency.h"
+#include "logger.h"
+#include "perf_counters.h"
+#include "profiler.h"
+#include "render_list.h"
+#include "render_target.h"
+#include "sampler.h"
+#include "shader_cache.h"
+#include "snapshot.h"
+#include "sprite_mesh.h"
+#include "startup_trace.h"
+#include "vertex_format.h"
+
+// text must be a literal, it is formatted later by the logger thread.
 void debug(const char* text) {
-    printf("[DEBUG] %s\n", text);
+    log_message("[DEBUG] %s\n", text);
 }
 
 void create_next_phase();
 void setup_game();
 
-#define BUFF_SIZE 2048
+#define BUFF_SIZE 4096
 #define MAX_BULLETS 512
 
 #define MAX_ENEMIES 16
@@ -38,12 +64,27 @@ int print_debug = 0;
 #define ENEMIES_HEIGHT 60.0f
 #define ENEMIES_WIDTH 60.0f
 
+#define BULLET_SIZE 40.0f
+
 int END_GAME = 0;
+int GL_REPORT = 0;
+int GL_STATS = 0;
+const char *sample_path = NULL;
+int sample_rate = SAMPLER_DEFAULT_HZ;
 int ENEMIES_CAN_SHOT = 1;
 
-unsigned int VAO, VBO;
+GLuint sprite_vaos[MAX_FRAMES_IN_FLIGHT], sprite_vbos[MAX_FRAMES_IN_FLIGHT];
+int sprite_vbo_capacity[MAX_FRAMES_IN_FLIGHT];
+SpriteVertex *sprite_vertices;
+int sprite_vertices_capacity;
+GLuint sprite_program;
+GLuint background_program;
+GLuint bullet_program;
+BackgroundMode BACKGROUND_MODE = BACKGROUND_TEXTURE;
+RenderList render_lists[2];
 
 int shoot;
+int shot_requested;
 double pause_start_time;
 double pause_x_cursor_pos, pause_y_cursor_pos;
 
@@ -89,37 +130,70 @@ int curr_bullet = 0;
 int PAUSE_GAME = 0;
 int DEBUG_MODE = 0;
 
+// Low-power mode: while the game is paused, unfocused or minimized nothing
+// moves, so frames are only drawn when an event marked the screen dirty.
+#define IDLE_WAIT_SECONDS 0.25
+int window_iconified = 0;
+int window_unfocused = 0;
+int frame_dirty = 1;
+
 Spaceship spaceship = { .entity = { .x=400.0f, .y=100.0f, .velocity=5.0f, .width=50.0f, .height=50.0f }, .ship = { .fire_rate=0.5, .last_shoot_time=-1 } };
 
-void print_entities() {
-    debug("Spaceship:");
-    printf("Coord: (%.2f, %.2f)\n", spaceship.entity.x, spaceship.entity.y);
+unsigned long long tick_count = 0;
+
+SnapshotEntity snapshot_entity(SnapshotKind kind, int index, const Entity *entity) {
+    SnapshotEntity snapshot = { 0 };
+    snapshot.kind = kind;
+    snapshot.index = index;
+    snapshot.x = entity->x;
+    snapshot.y = entity->y;
+    snapshot.velocity = entity->velocity;
+    snapshot.width = entity->width;
+    snapshot.height = entity->height;
+    snapshot.sprite = entity->sprite;
+    return snapshot;
+}
+
+// Writes the spaceship, every active enemy and bullet and the game counters.
+int write_snapshot() {
+    static SnapshotEntity entities[1 + MAX_ENEMIES + MAX_BULLETS];
+    int count = 0;
+
+    entities[count] = snapshot_entity(SNAPSHOT_SPACESHIP, 0, &spaceship.entity);
+    entities[count++].last_shoot_time = spaceship.ship.last_shoot_time;
 
-    debug("Enemies:");
     for (int i = 0; i < MAX_ENEMIES; ++i) {
 	if (enemies[i].entity.is_active) {
-	    printf("Enemy %d\n", i);
-	    printf("\tCoord: (%.2f, %.2f)\n", enemies[i].entity.x, enemies[i].entity.y);
-	    printf(
-		   "\tVelocity Vector: (%.2f, %.2f)\n",
-		   enemies[i].direction * enemies[i].entity.velocity,
-		   enemies[i].is_diving * enemies[i].entity.velocity
-	    );
+	    SnapshotEntity *enemy = &entities[count++];
+	    *enemy = snapshot_entity(SNAPSHOT_ENEMY, i, &enemies[i].entity);
+	    enemy->flags = enemies[i].is_diving ? SNAPSHOT_DIVING : 0;
+	    enemy->direction = enemies[i].direction;
+	    enemy->angle = enemies[i].angle;
+	    enemy->last_shoot_time = enemies[i].ship.last_shoot_time;
 	}
     }
 
-    debug("Bullets:");
     for (int i = 0; i < MAX_BULLETS; ++i) {
 	if (bullets[i].entity.is_active) {
-	    printf("Bullet %d\n", i);
-	    printf("\tCoord: (%.2f, %.2f)\n", bullets[i].entity.x, bullets[i].entity.y);
-	    printf(
-		   "\tVelocity Vector: (%.2f, %.2f)\n",
-		   0.0,
-		   bullets[i].entity.velocity
-	    );
+	    SnapshotEntity *bullet = &entities[count++];
+	    *bullet = snapshot_entity(SNAPSHOT_BULLET, i, &bullets[i].entity);
+	    bullet->flags = bullets[i].from_enemy ? SNAPSHOT_FROM_ENEMY : 0;
 	}
     }
+
+    SnapshotRecord record = {
+	.magic = SNAPSHOT_RECORD_MAGIC,
+	.num_entities = count,
+	.tick = tick_count,
+	.time = glfwGetTime(),
+	.enemies_alive = enemies_alive,
+	.curr_divers = curr_divers,
+	.max_divers = max_divers,
+	.ticks = ticks,
+	.flags = (PAUSE_GAME ? SNAPSHOT_PAUSED : 0) | (END_GAME ? SNAPSHOT_GAME_OVER : 0) |
+		 (DEBUG_MODE ? SNAPSHOT_DEBUG_MODE : 0),
+    };
+    return snapshot_write(&record, entities);
 }
 
 int next_bullet = 0;
@@ -130,6 +204,8 @@ int get_available_bullet() {
 }
 
 int check_collision(Entity *a, Entity *b) {
+    // Too short to time; a timer would cost more than the test itself.
+    INSTRUMENT_COUNT("collision_checks", 1);
     return
 	a->x + a->width / 2.0f >= b->x - b->width / 2.0f &&
 	a->x - a->width / 2.0f <= b->x + b->width / 2.0f &&
@@ -143,19 +219,23 @@ void move_cursor_to_middle(GLFWwindow *window) {
     glfwSetCursorPos(window, windowWidth / 2.0, windowHeight / 2.0);
 }
 
+// Moves every fire cooldown forward, so time spent frozen does not count
+// towards the next shot.
+void delay_shots(double duration) {
+    for (int i = 0; i < MAX_ENEMIES; ++i) {
+        enemies[i].ship.last_shoot_time += duration;
+    }
+
+    spaceship.ship.last_shoot_time += duration;
+}
+
 void pause(GLFWwindow *window) {
     PAUSE_GAME = !PAUSE_GAME;
     if (PAUSE_GAME) {
         pause_start_time = glfwGetTime();
 	glfwGetCursorPos(window, &pause_x_cursor_pos, &pause_y_cursor_pos);
     } else {
-        double pause_duration = glfwGetTime() - pause_start_time;
-
-        for (int i = 0; i < MAX_ENEMIES; ++i) {
-            enemies[i].ship.last_shoot_time += pause_duration;
-        }
-
-        spaceship.ship.last_shoot_time += pause_duration;
+	delay_shots(glfwGetTime() - pause_start_time);
 	glfwSetCursorPos(window, pause_x_cursor_pos, pause_y_cursor_pos);
     }
 }
@@ -165,7 +245,7 @@ void restart(GLFWwindow* window) {
     setup_game();
 }
 
-void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+void handle_key(GLFWwindow* window, int key, int action) {
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
         glfwSetWindowShouldClose(window, 1);
     if (key == GLFW_KEY_R && action == GLFW_PRESS)
@@ -187,10 +267,13 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     }
 }
 
-void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
+void handle_mouse_button(GLFWwindow* window, int button, int action) {
     if (button == GLFW_MOUSE_BUTTON_LEFT && !PAUSE_GAME) {
-	if (action == GLFW_PRESS)
+	if (action == GLFW_PRESS) {
 	    shoot = 1;
+	    // Fire on the next tick even if the button is already up again.
+	    shot_requested = 1;
+	}
 	else if (action == GLFW_RELEASE) {
 	    shoot = 0;
 	}
@@ -204,13 +287,87 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
     }
 }
 
+// The callbacks only queue events; the simulation applies them at the
+// start of the next tick (process_input).
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    frame_dirty = 1;
+    input_push((InputEvent){ .type = INPUT_KEY, .code = key, .action = action });
+}
+
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
+    frame_dirty = 1;
+    input_push((InputEvent){ .type = INPUT_MOUSE_BUTTON, .code = button, .action = action });
+}
+
 void cursor_position_callback(GLFWwindow* window, double xpos, double ypos) {
-    if (PAUSE_GAME)
+    if (PAUSE_GAME || window_unfocused)
         return;
 
+    frame_dirty = 1;
+    input_push((InputEvent){ .type = INPUT_CURSOR, .x = xpos, .y = ypos });
+}
+
+// Applies the queued input in order. Returns the time of the oldest event,
+// or 0 if there was none; *pressed tells whether a key or button went down
+// and *moved whether the cursor did.
+uint64_t process_input(GLFWwindow *window, int *pressed, int *moved) {
+    uint64_t oldest = 0;
+    InputEvent event;
+    *pressed = 0;
+    *moved = 0;
+    while (input_pop(&event)) {
+	if (!oldest)
+	    oldest = event.time_ns;
+	if (event.type == INPUT_CURSOR)
+	    *moved = 1;
+	else if (event.action == GLFW_PRESS)
+	    *pressed = 1;
+
+	if (event.type == INPUT_KEY)
+	    handle_key(window, event.code, event.action);
+	else if (event.type == INPUT_MOUSE_BUTTON)
+	    handle_mouse_button(window, event.code, event.action);
+	// Cursor events only carry the timestamp; the position itself is
+	// read by latch_cursor.
+    }
+    return oldest;
+}
+
+// Reads the cursor right before the ship's position is used for this
+// tick's shot and draw data, rather than whenever events were polled.
+// Only called on ticks the cursor moved, so the ship otherwise stays where
+// the game put it (create_next_phase recenters it).
+void latch_cursor(GLFWwindow *window) {
+    if (PAUSE_GAME)
+	return;
+
+    double xpos, ypos;
+    glfwGetCursorPos(window, &xpos, &ypos);
     spaceship.entity.x = xpos - spaceship.entity.width / 2.0;
 }
 
+// Losing focus or being minimized only freezes the game; it carries on by
+// itself once the window is back.
+void window_focus_callback(GLFWwindow* window, int focused) {
+    window_unfocused = !focused;
+    frame_dirty = 1;
+}
+
+void window_iconify_callback(GLFWwindow* window, int iconified) {
+    window_iconified = iconified;
+    frame_dirty = 1;
+}
+
+void window_refresh_callback(GLFWwindow* window) {
+    frame_dirty = 1;
+}
+
+// Nothing changes on screen by itself: paused with no debug countdown
+// pending, in the background or not visible at all.
+int game_is_idle() {
+    return window_iconified || window_unfocused || (PAUSE_GAME && ticks == 0 && !print_debug);
+}
+
 int read_file(const char* file_name, char* buffer) {
     FILE* file = fopen(file_name, "r");
     if (!file) {
@@ -218,7 +375,7 @@ int read_file(const char* file_name, char* buffer) {
 	return -1;
     }
 
-    size_t read_size = fread((void*)buffer, sizeof(char), BUFF_SIZE, file);
+    size_t read_size = fread((void*)buffer, sizeof(char), BUFF_SIZE - 1, file);
     if (read_size <= 0) {
 	fclose(file);
 	return -1;
@@ -229,9 +386,16 @@ int read_file(const char* file_name, char* buffer) {
     return 1;
 }
 
-int compile_shaders(unsigned int *vertex_shader, unsigned int *fragment_shader, unsigned int *shader_program) {
+int compile_shaders(const char *vertex_path, const char *fragment_path,
+		    unsigned int *vertex_shader, unsigned int *fragment_shader, unsigned int *shader_program) {
     char vertex_source[BUFF_SIZE];
-    read_file("vertex_shader.glsl", vertex_source);
+    read_file(vertex_path, vertex_source);
+
+    char fragment_source[BUFF_SIZE];
+    read_file(fragment_path, fragment_source);
+
+    if (shader_cache_load(*shader_program, vertex_source, fragment_source))
+	return 1;
 
     const char* vertex_sources[] = { vertex_source };
     glShaderSource(*vertex_shader, 1, vertex_sources, NULL);
@@ -241,39 +405,39 @@ int compile_shaders(unsigned int *vertex_shader, unsigned int *fragment_shader,
     char infoLog[512];
     glGetShaderiv(*vertex_shader, GL_COMPILE_STATUS, &success);
     if (!success) {
-	glGetShaderInfoLog(*vertex_shader, BUFF_SIZE, NULL, infoLog);
-	printf("[ERRO]: vertex_shader compilation failed: %s\n", infoLog);
+	glGetShaderInfoLog(*vertex_shader, sizeof(infoLog), NULL, infoLog);
+	printf("[ERRO]: %s compilation failed: %s\n", vertex_path, infoLog);
 	return success;
     }
 
-    char fragment_source[BUFF_SIZE];
-    read_file("fragment_shader.glsl", fragment_source);
-
     const char* fragment_sources[] = { fragment_source };
     glShaderSource(*fragment_shader, 1, fragment_sources, NULL);
     glCompileShader(*fragment_shader);
 
     glGetShaderiv(*fragment_shader, GL_COMPILE_STATUS, &success);
     if (!success) {
-	glGetShaderInfoLog(*fragment_shader, BUFF_SIZE, NULL, infoLog);
-	printf("[ERRO]: fragment_shader compilation failed: %s\n", infoLog);
+	glGetShaderInfoLog(*fragment_shader, sizeof(infoLog), NULL, infoLog);
+	printf("[ERRO]: %s compilation failed: %s\n", fragment_path, infoLog);
 	return success;
     }
 
     glAttachShader(*shader_program, *vertex_shader);
     glAttachShader(*shader_program, *fragment_shader);
+    shader_cache_prepare(*shader_program);
     glLinkProgram(*shader_program);
-    glGetShaderiv(*shader_program, GL_LINK_STATUS, &success);
+    glGetProgramiv(*shader_program, GL_LINK_STATUS, &success);
     if (!success) {
-	glGetShaderInfoLog(*shader_program, BUFF_SIZE, NULL, infoLog);
+	glGetProgramInfoLog(*shader_program, sizeof(infoLog), NULL, infoLog);
 	printf("[ERRO]: shader_program linkage failed: %s\n", infoLog);
 	return success;
     }
 
+    shader_cache_store(*shader_program, vertex_source, fragment_source);
     return success;
 }
 
 GLuint load_texture(char const * path) {
+    chrome_trace_begin_detail("load_texture", path);
     GLuint textureID;
     glGenTextures(1, &textureID);
 
@@ -285,7 +449,7 @@ GLuint load_texture(char const * path) {
         else if (nrComponents == 3) format = GL_RGB;
         else if (nrComponents == 4) format = GL_RGBA;
 
-        glBindTexture(GL_TEXTURE_2D, textureID);
+        gl_state_bind_texture(textureID);
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);  // Add this line
         glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
         glGenerateMipmap(GL_TEXTURE_2D);
@@ -299,18 +463,39 @@ GLuint load_texture(char const * path) {
         printf("Texture failed to load at path: %s", path);
     }
     stbi_image_free(data);
+    sprite_mesh_load(textureID, path);
+    startup_trace_mark(path);
+    chrome_trace_end("load_texture");
     return textureID;
 }
 
 
+// Vertex positions are encoded relative to the visible world (see
+// vertex_format.h), so the projection stays the same across resizes.
+void update_projection() {
+    mat4 projection;
+    glm_ortho(0, VERTEX_POSITION_EDGE, 0, VERTEX_POSITION_EDGE, -1.0, 1.0, projection);
+
+    GLuint programs[] = { sprite_program, background_program, bullet_program };
+    for (int i = 0; i < 3; ++i) {
+	if (!programs[i])
+	    continue;
+	gl_state_use_program(programs[i]);
+	glUniformMatrix4fv(glGetUniformLocation(programs[i], "transform"), 1, GL_FALSE, &projection[0][0]);
+    }
+}
+
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
+    frame_dirty = 1;
     screen_width = width;
     screen_height = height;
-    glViewport(0, 0, width, height);
+    render_target_resize(width, height);
+    background_resize(width, height);
 }
 
 void configure_window(GLFWwindow **window) {
     glfwInit();
+    startup_trace_mark("glfwInit");
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
@@ -321,6 +506,7 @@ void configure_window(GLFWwindow **window) {
 	glfwTerminate();
 	exit(1);
     }
+    startup_trace_mark("glfwCreateWindow");
 
     glfwMakeContextCurrent(*window);
 
@@ -329,136 +515,159 @@ void configure_window(GLFWwindow **window) {
 	glfwTerminate();
 	exit(1);
     }
+    startup_trace_mark("gladLoadGLLoader");
+
+    if (GL_STATS)
+	gl_stats_install();
 
-    glEnable(GL_BLEND);
+    gl_state_blend(1);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     glfwSetInputMode(*window, GLFW_REPEAT, GLFW_FALSE);
 
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
+    // The attribute layout is stored in the VAOs, so it is specified once
+    // here. There is one VAO/VBO pair per frame slot (frame_pipeline.h).
+    glGenVertexArrays(MAX_FRAMES_IN_FLIGHT, sprite_vaos);
+    glGenBuffers(MAX_FRAMES_IN_FLIGHT, sprite_vbos);
+    for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+	gl_state_bind_vao(sprite_vaos[i]);
+	gl_state_bind_buffer(GL_ARRAY_BUFFER, sprite_vbos[i]);
+	vertex_format_sprite_layout();
+    }
+
     glViewport(0, 0, 800, 600);
     glfwSetFramebufferSizeCallback(*window, framebuffer_size_callback);
 }
 
-void draw_spaceship(float x, float y) {
-    glBindTexture(GL_TEXTURE_2D, spaceship.entity.sprite);
-
-    float vertices[] = {
-        // positions          // texture coords
-        x - spaceship.entity.width / 2.0f, y - spaceship.entity.height / 2.0f, 0.0f, 0.0f, 1.0f,
-        x + spaceship.entity.width / 2.0f, y - spaceship.entity.height / 2.0f, 0.0f, 1.0f, 1.0f,
-        x - spaceship.entity.width / 2.0f, y + spaceship.entity.height / 2.0f, 0.0f, 0.0f, 0.0f,
-        x + spaceship.entity.width / 2.0f, y + spaceship.entity.height / 2.0f, 0.0f, 1.0f, 0.0f
-    };
-
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+// Writes the vertices of a sprite centred on (x, y) using its trimmed
+// outline and returns how many there are. Images are stored top row
+// first; upside_down maps the top of the image to the bottom of the
+// sprite, which is how enemies face the player.
+int build_sprite_vertices(SpriteVertex *vertices, GLuint texture, float x, float y, float width, float height, int upside_down) {
+    const SpriteMesh *mesh = sprite_mesh_get(texture);
+
+    for (int i = 0; i < mesh->count; ++i) {
+	float u = mesh->uv[i][0];
+	float v = mesh->uv[i][1];
+	float vertex_x = x - width / 2.0f + u * width;
+	float vertex_y = upside_down ? y - height / 2.0f + v * height : y + height / 2.0f - v * height;
+
+	vertices[i].x = vertex_position(vertex_x, screen_width);
+	vertices[i].y = vertex_position(vertex_y, screen_height);
+	vertices[i].u = vertex_texcoord(u);
+	vertices[i].v = vertex_texcoord(v);
+    }
 
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    return mesh->count;
 }
 
-void draw_enemy(Enemy enemy) {
-    glBindTexture(GL_TEXTURE_2D, enemy.entity.sprite);
-
-    float vertices[] = {
-        // positions          // texture coords
-        enemy.entity.x - enemy.entity.width / 2.0f, enemy.entity.y - enemy.entity.height / 2.0f, 0.0f, 0.0f, 0.0f,
-        enemy.entity.x + enemy.entity.width / 2.0f, enemy.entity.y - enemy.entity.height / 2.0f, 0.0f, 1.0f, 0.0f,
-        enemy.entity.x - enemy.entity.width / 2.0f, enemy.entity.y + enemy.entity.height / 2.0f, 0.0f, 0.0f, 1.0f,
-        enemy.entity.x + enemy.entity.width / 2.0f, enemy.entity.y + enemy.entity.height / 2.0f, 0.0f, 1.0f, 1.0f
-    };
+// Uploads the sprite vertices of the whole frame into the current slot's
+// buffer at once. The slot is not in use by the GPU any more, so the
+// buffer is updated in place.
+void upload_sprite_vertices(int count) {
+    int slot = frame_pipeline_slot();
+    gl_state_bind_vao(sprite_vaos[slot]);
+    gl_state_bind_buffer(GL_ARRAY_BUFFER, sprite_vbos[slot]);
+
+    if (sprite_vbo_capacity[slot] < count) {
+	sprite_vbo_capacity[slot] = sprite_vertices_capacity;
+	glBufferData(GL_ARRAY_BUFFER, sprite_vbo_capacity[slot] * sizeof(SpriteVertex), NULL, GL_STREAM_DRAW);
+    }
+    if (count > 0)
+	glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(SpriteVertex), sprite_vertices);
+}
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+// Renderer pass: draws a recorded frame, which must already be sorted.
+// Bullets that can be points are batched into the bullet pass, which is
+// flushed last; that matches the sort order because bullets are the top
+// layer.
+void submit_render_list(const RenderList *list) {
+    INSTRUMENT_SCOPE("submit_render_list");
+    int use_points = bullet_mode == BULLETS_POINTS;
+
+    int needed = list->count * MAX_MESH_VERTICES;
+    if (sprite_vertices_capacity < needed) {
+	SpriteVertex *vertices = realloc(sprite_vertices, needed * sizeof(SpriteVertex));
+	if (!vertices) {
+	    printf("[ERROR] Out of memory for sprite vertices\n");
+	    return;
+	}
+	sprite_vertices = vertices;
+	sprite_vertices_capacity = needed;
+    }
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+    int num_vertices = 0;
+    for (int i = 0; i < list->count; ++i) {
+	const RenderCommand *command = render_list_get(list, i);
+	if (use_points && (command->flags & RENDER_POINT))
+	    continue;
+	num_vertices += build_sprite_vertices(&sprite_vertices[num_vertices], command->texture,
+					      command->x, command->y, command->width, command->height,
+					      command->flags & RENDER_UPSIDE_DOWN);
+    }
+    upload_sprite_vertices(num_vertices);
+    INSTRUMENT_GAUGE("sprite_vertices", num_vertices);
+
+    // Every sprite has an alpha edge, so everything is blended.
+    gl_state_use_program(sprite_program);
+    gl_state_blend(1);
+    if (use_points)
+	bullet_pass_begin(screen_width, screen_height);
+
+    int first = 0;
+    for (int i = 0; i < list->count; ++i) {
+	const RenderCommand *command = render_list_get(list, i);
+	if (use_points && (command->flags & RENDER_POINT)) {
+	    bullet_pass_add(command->texture, command->x, command->y);
+	    continue;
+	}
 
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+	int count = sprite_mesh_get(command->texture)->count;
+	gl_state_bind_texture(command->texture);
+	glDrawArrays(GL_TRIANGLE_FAN, first, count);
+	first += count;
+    }
 
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    if (use_points)
+	bullet_pass_draw(BULLET_SIZE);
 }
 
-void draw_bullet(Bullet bullet) {
-    float halfWidth = 10.0;
-    float height = 10.0;
-    glBindTexture(GL_TEXTURE_2D, bullet.entity.sprite);
-
-    float vertices[] = {
-        // positions          // texture coords
-        bullet.entity.x - bullet.entity.width / 2.0f, bullet.entity.y - bullet.entity.height / 2.0f, 0.0f, 0.0f, 1.0f,
-        bullet.entity.x + bullet.entity.width / 2.0f, bullet.entity.y - bullet.entity.height / 2.0f, 0.0f, 1.0f, 1.0f,
-        bullet.entity.x - bullet.entity.width / 2.0f, bullet.entity.y + bullet.entity.height / 2.0f, 0.0f, 0.0f, 0.0f,
-        bullet.entity.x + bullet.entity.width / 2.0f, bullet.entity.y + bullet.entity.height / 2.0f, 0.0f, 1.0f, 0.0f
+// Entities higher up the screen are further back, so lower ones are drawn
+// over them.
+void emit_entity(RenderList *list, const Entity *entity, RenderLayer layer, int flags) {
+    float height = entity->y / screen_height;
+    if (height < 0.0f)
+	height = 0.0f;
+    if (height > 1.0f)
+	height = 1.0f;
+
+    RenderCommand command = {
+	.x = entity->x, .y = entity->y,
+	.width = entity->width, .height = entity->height,
+	.texture = entity->sprite,
+	.layer = layer,
+	.flags = flags,
+	.depth = (unsigned short)((1.0f - height) * 65535.0f),
     };
-
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    render_list_push(list, command);
 }
 
+// Records what the current world state looks like. Called once the
+// simulation step is complete, so what is drawn is always consistent.
+void emit_render_commands(RenderList *list) {
+    render_list_clear(list);
+
+    emit_entity(list, &spaceship.entity, RENDER_LAYER_SHIP, 0);
 
-void draw_enemies() {
     for (int i = 0; i < MAX_ENEMIES; ++i)
 	if (enemies[i].entity.is_active)
-	    draw_enemy(enemies[i]);
-}
+	    emit_entity(list, &enemies[i].entity, RENDER_LAYER_ENEMIES, RENDER_UPSIDE_DOWN);
 
-void draw_background(GLFWwindow *window,  GLuint texture) {
-    int windowWidth, windowHeight;
-    glfwGetWindowSize(window, &windowWidth, &windowHeight);
-    glBindTexture(GL_TEXTURE_2D, texture);
-
-    GLfloat vertices[] = {
-	0.0f , 0.0f, 0.0f, 0.0f, 1.0f,
-        windowWidth, 0.0f, 0.0f, 1.0f, 1.0f,
-        0.0f, windowHeight, 0.0f, 0.0f, 0.0f,
-        windowWidth, windowHeight, 0.0f, 1.0f, 0.0f
-    };
-
-    GLuint vao, vbo;
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
-
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glBindVertexArray(vao);
-
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    glDeleteVertexArrays(1, &vao);
-    glDeleteBuffers(1, &vbo);
+    // Bullets whose sprite has no layer in the bullet pass stay quads.
+    for (int i = 0; i < MAX_BULLETS; ++i)
+	if (bullets[i].entity.is_active)
+	    emit_entity(list, &bullets[i].entity, RENDER_LAYER_BULLETS,
+			bullet_pass_layer(bullets[i].entity.sprite) >= 0 ? RENDER_POINT : 0);
 }
 
 void enemy_shot(Enemy *enemy) {
@@ -485,42 +694,63 @@ void enemy_shot(Enemy *enemy) {
     }
 }
 
+int count_active_bullets() {
+    int count = 0;
+    for (int i = 0; i < MAX_BULLETS; ++i)
+	count += bullets[i].entity.is_active;
+    return count;
+}
+
+// Returns 1 when an enemy bullet hit the player.
+int collide_bullet(Bullet *bullet) {
+    if (bullet->from_enemy == 1)
+	return check_collision(&bullet->entity, &spaceship.entity);
+
+    for (int j = 0; j < MAX_ENEMIES; ++j) {
+	if (enemies[j].entity.is_active) {
+	    if (check_collision(&bullet->entity, &enemies[j].entity)) {
+		enemies[j].entity.is_active = 0;
+		bullet->entity.is_active = 0;
+
+		enemies_alive--;
+	    }
+	}
+    }
+    return 0;
+}
+
 void update_bullets() {
+    INSTRUMENT_SCOPE("update_bullets");
+    if (PAUSE_GAME)
+	return;
+
     for (int i = 0; i < MAX_BULLETS; ++i) {
 	if (bullets[i].entity.is_active) {
-	    if (!PAUSE_GAME) {
-		bullets[i].entity.y += bullets[i].entity.velocity;
-	    }
-
-	    draw_bullet(bullets[i]);
+	    bullets[i].entity.y += bullets[i].entity.velocity;
+	}
+    }
+}
 
+// Separate pass after update_bullets, so the collision tests can be
+// measured as one region per tick.
+void collide_bullets() {
+    INSTRUMENT_SCOPE("collide_bullets");
+    for (int i = 0; i < MAX_BULLETS; ++i) {
+	if (bullets[i].entity.is_active) {
 	    if (bullets[i].entity.y >= screen_height || bullets[i].entity.y <= 0) {
 		bullets[i].entity.is_active = 0;
 	    }
 
-	    if (bullets[i].from_enemy == 1) {
-		if (check_collision(&bullets[i].entity, &spaceship.entity)) {
-		    END_GAME = 1;
-		    return;
-		}
-		continue;
-	    }
-
-	    for (int j = 0; j < MAX_ENEMIES; ++j) {
-		if (enemies[j].entity.is_active) {
-		    if (check_collision(&bullets[i].entity, &enemies[j].entity)) {
-			enemies[j].entity.is_active = 0;
-			bullets[i].entity.is_active = 0;
-
-			enemies_alive--;
-		    }
-		}
+	    if (collide_bullet(&bullets[i])) {
+		END_GAME = 1;
+		return;
 	    }
 	}
     }
 }
 
 void update_enemies() {
+    INSTRUMENT_SCOPE("update_enemies");
     if (PAUSE_GAME)
 	return;
 
@@ -594,7 +824,9 @@ void handle_movement() {
 
     double curr_time = glfwGetTime();
     double curr_shoot_delay = curr_time - spaceship.ship.last_shoot_time;
-    if (shoot && curr_shoot_delay >= spaceship.ship.fire_rate) {
+    int wants_shot = shoot || shot_requested;
+    shot_requested = 0;
+    if (wants_shot && curr_shoot_delay >= spaceship.ship.fire_rate) {
 	int bullet_index = get_available_bullet();
 	if (bullet_index < 0) return;
 
@@ -683,12 +915,15 @@ void setup_game() {
     int quarter_enemies = MAX_ENEMIES / 4;
     GLuint enemy1_sprite = load_texture("./enemy1.png");
     GLuint bullet_enemy1_sprite = load_texture("./bullet_enemy1.png");
+    bullet_pass_register(bullet_enemy1_sprite, "./bullet_enemy1.png");
 
     GLuint enemy2_sprite = load_texture("./enemy2.png");
     GLuint bullet_enemy2_sprite = load_texture("./bullet_enemy2.png");
+    bullet_pass_register(bullet_enemy2_sprite, "./bullet_enemy2.png");
 
     GLuint enemy3_sprite = load_texture("./enemy3.png");
     GLuint bullet_enemy3_sprite = load_texture("./bullet_enemy3.png");
+    bullet_pass_register(bullet_enemy3_sprite, "./bullet_enemy3.png");
 
     for (int i = 0; i < MAX_ENEMIES; ++i) {
 	if (i < half_enemies) {
@@ -722,9 +957,10 @@ void setup_game() {
     create_next_phase();
 
     GLuint bullet_sprite = load_texture("bullet.png");
+    bullet_pass_register(bullet_sprite, "bullet.png");
     for (int i = 0; i < MAX_BULLETS; ++i) {
-	bullets[i].entity.width = 40.0;
-	bullets[i].entity.height = 40.0;
+	bullets[i].entity.width = BULLET_SIZE;
+	bullets[i].entity.height = BULLET_SIZE;
 	bullets[i].entity.sprite = bullet_sprite;
 	bullets[i].entity.is_active = 0;
 	bullets[i].entity.velocity = 0.0;
@@ -734,75 +970,367 @@ void setup_game() {
 }
 
 
-int main() {
+// One simulation step, recorded into list. Returns 0 once the game is
+// over.
+int simulate_frame(GLFWwindow *window, RenderList *list) {
+    static int next_phase_countdown = 0;
+
+    int input_pressed, cursor_moved;
+    uint64_t input_time = process_input(window, &input_pressed, &cursor_moved);
+    ++tick_count;
+
+    profiler_phase_begin(PHASE_UPDATE_ENEMIES);
+    perf_counters_begin(PERF_UPDATE_ENEMIES);
+    update_enemies();
+    perf_counters_end(PERF_UPDATE_ENEMIES);
+    profiler_phase_end(PHASE_UPDATE_ENEMIES);
+
+    profiler_phase_begin(PHASE_UPDATE_BULLETS);
+    perf_counters_begin(PERF_UPDATE_BULLETS);
+    update_bullets();
+    perf_counters_end(PERF_UPDATE_BULLETS);
+    perf_counters_begin(PERF_COLLISION);
+    collide_bullets();
+    perf_counters_end(PERF_COLLISION);
+    profiler_phase_end(PHASE_UPDATE_BULLETS);
+    perf_counters_tick();
+
+    profiler_phase_begin(PHASE_MOVEMENT);
+    if (cursor_moved)
+	latch_cursor(window);
+    handle_movement();
+    profiler_phase_end(PHASE_MOVEMENT);
+
+    if (snapshot_every_tick)
+	write_snapshot();
+
+    if (END_GAME)
+	return 0;
+
+    if (enemies_alive == 0) {
+	if (next_phase_countdown == 1 && ticks == 0) {
+	    create_next_phase();
+	    next_phase_countdown = 0;
+	}
+
+	else if (ticks == 0) {
+	    ticks = 60;
+	    next_phase_countdown = 1;
+	}
+    }
+
+    profiler_phase_begin(PHASE_EMIT);
+    emit_render_commands(list);
+    list->input_time_ns = input_time;
+    list->input_pressed = input_pressed;
+    profiler_phase_end(PHASE_EMIT);
+
+    profiler_phase_begin(PHASE_SORT);
+    render_list_sort(list);
+    profiler_phase_end(PHASE_SORT);
+    return 1;
+}
+
+// Matches "--name" and "--name=value". Returns the value ("" for a bare
+// flag) or NULL when arg is a different option.
+const char *match_option(const char *arg, const char *name) {
+    size_t len = strlen(name);
+    if (strncmp(arg, "--", 2) != 0 || strncmp(arg + 2, name, len) != 0)
+	return NULL;
+    if (arg[len + 2] == '\0')
+	return "";
+    if (arg[len + 2] == '=')
+	return arg + len + 3;
+    return NULL;
+}
+
+void parse_args(int argc, char **argv) {
+    const char *value;
+    for (int i = 1; i < argc; ++i) {
+	if ((value = match_option(argv[i], "startup-report"))) {
+	    startup_trace_enable(*value ? value : NULL);
+	} else if (match_option(argv[i], "gl-report")) {
+	    GL_REPORT = 1;
+	} else if ((value = match_option(argv[i], "background"))) {
+	    if (strcmp(value, "texture") == 0) {
+		BACKGROUND_MODE = BACKGROUND_TEXTURE;
+	    } else if (strcmp(value, "starfield") == 0) {
+		BACKGROUND_MODE = BACKGROUND_STARFIELD;
+	    } else {
+		printf("[ERROR] Unknown background: %s (texture or starfield)\n", value);
+		exit(1);
+	    }
+	} else if ((value = match_option(argv[i], "internal-resolution"))) {
+	    int width, height;
+	    if (sscanf(value, "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0) {
+		printf("[ERROR] Expected --internal-resolution=WIDTHxHEIGHT\n");
+		exit(1);
+	    }
+	    render_target_enable(width, height);
+	} else if ((value = match_option(argv[i], "dynamic-resolution"))) {
+	    render_target_enable_governor(*value ? atof(value) : 12.0);
+	} else if ((value = match_option(argv[i], "bullets"))) {
+	    if (strcmp(value, "points") == 0) {
+		bullet_mode = BULLETS_POINTS;
+	    } else if (strcmp(value, "quads") == 0) {
+		bullet_mode = BULLETS_QUADS;
+	    } else {
+		printf("[ERROR] Unknown bullet mode: %s (points or quads)\n", value);
+		exit(1);
+	    }
+	} else if ((value = match_option(argv[i], "frames-in-flight"))) {
+	    frames_in_flight = atoi(value);
+	    if (frames_in_flight < 1 || frames_in_flight > MAX_FRAMES_IN_FLIGHT) {
+		printf("[ERROR] Expected --frames-in-flight=N with N from 1 to %d\n", MAX_FRAMES_IN_FLIGHT);
+		exit(1);
+	    }
+	} else if ((value = match_option(argv[i], "pacing"))) {
+	    if (!frame_pacing_parse(value)) {
+		printf("[ERROR] Unknown pacing: %s (vsync, adaptive, uncapped or cap[:FPS])\n", value);
+		exit(1);
+	    }
+	} else if ((value = match_option(argv[i], "latency-log")) && *value) {
+	    latency_open_log(value);
+	} else if (match_option(argv[i], "latency-marker")) {
+	    latency_marker_enabled = 1;
+	} else if (match_option(argv[i], "no-sprite-meshes")) {
+	    sprite_meshes_enabled = 0;
+	} else if ((value = match_option(argv[i], "sample"))) {
+	    sample_path = *value ? value : "galaga.folded";
+	} else if ((value = match_option(argv[i], "sample-rate"))) {
+	    sample_rate = atoi(value);
+	    if (sample_rate <= 0) {
+		printf("[ERROR] Expected --sample-rate=HZ with HZ above 0\n");
+		exit(1);
+	    }
+	} else if ((value = match_option(argv[i], "snapshots")) && *value) {
+	    snapshot_path = value;
+	} else if (match_option(argv[i], "snapshot-every-tick")) {
+	    snapshot_every_tick = 1;
+	} else if (match_option(argv[i], "perf-counters")) {
+	    perf_counters_enabled = 1;
+	} else if (match_option(argv[i], "instrument")) {
+	    instrument_enable();
+	} else if ((value = match_option(argv[i], "trace"))) {
+	    chrome_trace_open(*value ? value : "galaga-trace.json");
+	} else if ((value = match_option(argv[i], "hitch-budget"))) {
+	    if (*value && atof(value) <= 0) {
+		printf("[ERROR] Expected --hitch-budget=MS with MS above 0\n");
+		exit(1);
+	    }
+	    if (*value)
+		hitch_budget_ms = atof(value);
+	    hitch_enabled = 1;
+	} else if ((value = match_option(argv[i], "hitch-log")) && *value) {
+	    hitch_log_path = value;
+	    hitch_enabled = 1;
+	} else if (match_option(argv[i], "profile")) {
+	    profiler_enabled = 1;
+	} else if (match_option(argv[i], "gl-stats")) {
+	    GL_STATS = 1;
+	} else if ((value = match_option(argv[i], "gl-stats-csv")) && *value) {
+	    GL_STATS = 1;
+	    gl_stats_open_csv(value);
+	} else {
+	    printf("[ERROR] Unknown option: %s\n", argv[i]);
+	    exit(1);
+	}
+    }
+
+    // A hitch is logged with its phase breakdown and GL counters.
+    if (hitch_enabled) {
+	profiler_collect = 1;
+	GL_STATS = 1;
+    }
+}
+
+int main(int argc, char **argv) {
+    parse_args(argc, argv);
+    if (hitch_enabled)
+	hitch_open();
+    perf_counters_init();
+    logger_start();
+    if (sample_path)
+	sampler_start(sample_path, sample_rate);
+
     GLFWwindow *window;
     configure_window(&window);
+    startup_trace_mark("configure_window");
+    if (GL_REPORT)
+	gl_loader_report();
+    frame_pacing_init();
 
     srand((unsigned int)time(NULL));
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
     unsigned int vertex_shader = glCreateShader(GL_VERTEX_SHADER);
     unsigned int fragment_shader = glCreateShader(GL_FRAGMENT_SHADER);
-    unsigned int shader_program = glCreateProgram();
-    compile_shaders(&vertex_shader, &fragment_shader, &shader_program);
+    sprite_program = glCreateProgram();
+    compile_shaders("vertex_shader.glsl", "fragment_shader.glsl", &vertex_shader, &fragment_shader, &sprite_program);
+
+    background_program = sprite_program;
+    if (BACKGROUND_MODE == BACKGROUND_STARFIELD) {
+	unsigned int starfield_shader = glCreateShader(GL_FRAGMENT_SHADER);
+	background_program = glCreateProgram();
+	compile_shaders("vertex_shader.glsl", "starfield_fragment.glsl", &vertex_shader, &starfield_shader, &background_program);
+    }
 
-    glUseProgram(shader_program);
+    if (bullet_mode == BULLETS_POINTS) {
+	unsigned int bullet_vertex_shader = glCreateShader(GL_VERTEX_SHADER);
+	unsigned int bullet_fragment_shader = glCreateShader(GL_FRAGMENT_SHADER);
+	bullet_program = glCreateProgram();
+	compile_shaders("bullet_vertex.glsl", "bullet_fragment.glsl", &bullet_vertex_shader, &bullet_fragment_shader, &bullet_program);
+	bullet_pass_init(bullet_program);
+    }
+    startup_trace_mark("compile_shaders");
 
     glfwGetWindowSize(window, &screen_width, &screen_height);
-    mat4 projection;
-    glm_ortho(0, (float) screen_width, 0, (float) screen_height, -1.0, 1.0, projection);
-    int transform_loc = glGetUniformLocation(shader_program, "transform");
+    update_projection();
 
-    glUniformMatrix4fv(transform_loc, 1, GL_FALSE, &projection[0][0]);
+    int framebuffer_width, framebuffer_height;
+    glfwGetFramebufferSize(window, &framebuffer_width, &framebuffer_height);
+    render_target_init(framebuffer_width, framebuffer_height);
 
     glfwSetKeyCallback(window, key_callback);
     glfwSetMouseButtonCallback(window, mouse_button_callback);
     glfwSetCursorPosCallback(window, cursor_position_callback);
+    glfwSetWindowFocusCallback(window, window_focus_callback);
+    glfwSetWindowIconifyCallback(window, window_iconify_callback);
+    glfwSetWindowRefreshCallback(window, window_refresh_callback);
 
+    chrome_trace_begin("setup_game");
     setup_game();
-    int next_phase_countdown = 0;
-
-    GLuint background_texture = load_texture("bg.png");
-    while (!glfwWindowShouldClose(window)) {
-	glClear(GL_COLOR_BUFFER_BIT);
-	draw_background(window, background_texture);
+    chrome_trace_end("setup_game");
+    startup_trace_mark("setup_game");
+    if (BACKGROUND_MODE == BACKGROUND_STARFIELD)
+	background_init(BACKGROUND_STARFIELD, background_program, 0, screen_width, screen_height);
+    else
+	background_init(BACKGROUND_TEXTURE, background_program, load_texture("bg.png"), screen_width, screen_height);
+
+    // Pipelined, a frame is submitted while the next one is simulated, so
+    // each iteration draws the list recorded by the previous one.
+    int pipelined = frames_in_flight > 1;
+    int recorded = 0;
+    if (pipelined)
+	simulate_frame(window, &render_lists[recorded]);
+
+    int slept = 0;
+    double held_since = -1.0;
+    while (!END_GAME && !glfwWindowShouldClose(window)) {
+	// Time the window holds the game while it is not paused; pause()
+	// already accounts for time spent paused.
+	int held = (window_iconified || window_unfocused) && !PAUSE_GAME;
+	if (held && held_since < 0.0) {
+	    held_since = glfwGetTime();
+	} else if (!held && held_since >= 0.0) {
+	    delay_shots(glfwGetTime() - held_since);
+	    held_since = -1.0;
+	}
 
-	draw_spaceship(spaceship.entity.x, spaceship.entity.y);
-	draw_enemies();
-	update_enemies();
-	update_bullets();
-	handle_movement();
+	if (game_is_idle() && (window_iconified || !frame_dirty)) {
+	    glfwWaitEventsTimeout(IDLE_WAIT_SECONDS);
+	    frame_pacing_reset();
+	    slept = 1;
+	    continue;
+	}
+	frame_dirty = 0;
+
+	// Unfocused, a dirty frame (uncovered, resized) is only redrawn; the
+	// world does not move. Paused, it is simulated as usual so clicks
+	// that unpause are applied.
+	int redraw_only = held;
+
+	profiler_begin_frame();
+
+	// The list recorded before going idle is stale; the world may have
+	// changed since (restart, resize), so record it again.
+	if (pipelined && slept) {
+	    emit_render_commands(&render_lists[recorded]);
+	    render_list_sort(&render_lists[recorded]);
+	    render_lists[recorded].input_time_ns = 0;
+	    render_lists[recorded].input_pressed = 0;
+	}
+	slept = 0;
 
-	if (END_GAME) {
+	if (!pipelined && !redraw_only && !simulate_frame(window, &render_lists[recorded]))
 	    break;
-	}
 
-	if (enemies_alive == 0) {
-	    if (next_phase_countdown == 1 && ticks == 0) {
-		create_next_phase();
-		next_phase_countdown = 0;
-	    }
+	profiler_phase_begin(PHASE_FENCE);
+	frame_pipeline_begin();
+	profiler_phase_end(PHASE_FENCE);
 
-	    else if (ticks == 0) {
-		ticks = 60;
-		next_phase_countdown = 1;
-	    }
+	render_target_begin();
+	glClear(GL_COLOR_BUFFER_BIT);
+	profiler_phase_begin(PHASE_BACKGROUND);
+	background_draw(glfwGetTime());
+	profiler_phase_end(PHASE_BACKGROUND);
+
+	int submitted = recorded;
+	profiler_phase_begin(PHASE_SUBMIT);
+	submit_render_list(&render_lists[submitted]);
+	profiler_phase_end(PHASE_SUBMIT);
+
+	render_target_end();
+	if (latency_marker_enabled && render_lists[submitted].input_pressed)
+	    latency_draw_marker();
+	frame_pipeline_end();
+	startup_trace_mark("first frame draw");
+
+	if (pipelined && !redraw_only) {
+	    recorded = !recorded;
+	    if (!simulate_frame(window, &render_lists[recorded]))
+		break;
 	}
 
+	frame_pacing_wait();
+	profiler_phase_begin(PHASE_SWAP);
 	glfwSwapBuffers(window);
+	profiler_phase_end(PHASE_SWAP);
+	frame_pacing_presented();
+	latency_frame_presented(render_lists[submitted].input_time_ns);
+	startup_trace_first_frame();
+
+	profiler_phase_begin(PHASE_POLL);
 	glfwPollEvents();
+	profiler_phase_end(PHASE_POLL);
+
+	gl_stats_end_frame();
+	profiler_end_frame();
+
+	if (hitch_enabled && hitch_check()) {
+	    HitchEntities entities = { count_active_bullets(), curr_divers, enemies_alive };
+	    hitch_record(&entities);
+	}
 
 	if (ticks > 0)
 	    ticks--;
 	if (print_debug == 1 && ticks == 0) {
 	    debug("DEBUG MODE");
-	    print_entities();
+	    // With --snapshot-every-tick this tick is already in the file.
+	    if ((snapshot_every_tick || write_snapshot()) && snapshot_flush())
+		log_message("[DEBUG] Snapshot of tick %llu written to %s\n", tick_count, snapshot_path);
+	    else
+		log_message("[ERROR] Failed to write the snapshot of tick %llu to %s\n", tick_count, snapshot_path);
 	    if (!PAUSE_GAME)
 		pause(window);
 	    print_debug = 0;
 	}
     }
 
+    for (int i = 0; i < 2; ++i)
+	render_list_free(&render_lists[i]);
+    frame_pipeline_shutdown();
+    latency_close();
+    hitch_close();
+    snapshot_close();
+    logger_stop();
+    chrome_trace_close();
+    instrument_report();
+    perf_counters_report("[PERF]", 1);
+    perf_counters_shutdown();
+    sampler_stop();
+    frame_pacing_report();
+    gl_stats_close();
     glfwTerminate();
     return 0;
 }
@@ -0,0 +1,25 @@
+#!/usr/bin/bash
+
+# Regenerates gl_functions.h, the list of GL entry points gl_loader.c
+# resolves, from the functions the game sources actually call.
+# Run it after adding a new gl* call or a source file to the game.
+
+set -e
+cd "$(dirname "$0")"
+
+# The game's sources are the ones run.sh compiles; standalone tools such
+# as sprite_hull.c are left out.
+sources=$(grep -m1 -E '^(clang|gcc) ' run.sh | tr ' ' '\n' | grep '\.c$' | grep -v -x -e glad.c -e gl_loader.c)
+
+{
+    echo "// Generated by gen_gl_loader.sh, do not edit."
+    echo "// Scanned sources: $(echo $sources)"
+    echo
+    echo "#define GL_FUNCTIONS(X) \\"
+    for fn in $(grep -ohE '\bgl[A-Z][A-Za-z0-9]*\b' $sources | sort -u); do
+        # Only core 3.3 functions; extensions are resolved by their users.
+        grep -q "glad_$fn = NULL;" glad.c || continue
+        echo "    X(PFN$(echo "$fn" | tr a-z A-Z)PROC, $fn) \\"
+    done
+    echo
+} > gl_functions.h
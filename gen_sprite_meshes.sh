@@ -0,0 +1,10 @@
+#!/usr/bin/bash
+
+# Rebuilds the .hull outline of every sprite. Run it after changing a
+# sprite image; bg.png is opaque and has no outline.
+
+set -xe
+cd "$(dirname "$0")"
+
+${CC:-clang} sprite_hull.c -lm -O2 -o sprite_hull
+./sprite_hull ship.png enemy1.png enemy2.png enemy3.png bullet.png bullet_enemy1.png bullet_enemy2.png bullet_enemy3.png
@@ -0,0 +1,66 @@
+/*
+
+    Minimal replacement for glad.c.
+
+    glad.c resolves all ~370 GL 1.0-3.3 entry points and walks the
+    extension list on startup. This loader only resolves the functions
+    listed in gl_functions.h (regenerate it with gen_gl_loader.sh) and
+    skips the extension scan entirely. It keeps glad's interface, so
+    glad/glad.h and gladLoadGLLoader work unchanged.
+
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <glad/glad.h>
+
+#include "gl_loader.h"
+#include "gl_functions.h"
+
+#define DEFINE_FUNCTION(type, name) type glad_##name = NULL;
+GL_FUNCTIONS(DEFINE_FUNCTION)
+
+#define FUNCTION_ENTRY(type, name) { #name, (void **)&glad_##name },
+static struct {
+    const char *name;
+    void **pointer;
+} functions[] = {
+    GL_FUNCTIONS(FUNCTION_ENTRY)
+};
+
+#define NUM_FUNCTIONS ((int)(sizeof(functions) / sizeof(functions[0])))
+
+struct gladGLversionStruct GLVersion = { 0, 0 };
+
+static int num_resolved = 0;
+
+int gladLoadGLLoader(GLADloadproc load) {
+    GLVersion.major = 0; GLVersion.minor = 0;
+    num_resolved = 0;
+
+    for (int i = 0; i < NUM_FUNCTIONS; ++i) {
+        *functions[i].pointer = load(functions[i].name);
+        if (*functions[i].pointer)
+            ++num_resolved;
+    }
+
+    if (glGetString == NULL)
+        return 0;
+
+    const char *version = (const char*)glGetString(GL_VERSION);
+    if (version == NULL)
+        return 0;
+
+    sscanf(version, "%d.%d", &GLVersion.major, &GLVersion.minor);
+    if (GLVersion.major < 3 || (GLVersion.major == 3 && GLVersion.minor < 3))
+        return 0;
+
+    return num_resolved == NUM_FUNCTIONS;
+}
+
+void gl_loader_report() {
+    printf("[GL] OpenGL %d.%d, resolved %d of %d entry points\n",
+           GLVersion.major, GLVersion.minor, num_resolved, NUM_FUNCTIONS);
+    for (int i = 0; i < NUM_FUNCTIONS; ++i)
+        printf("[GL]   %-32s %s\n", functions[i].name, *functions[i].pointer ? "ok" : "MISSING");
+}
@@ -0,0 +1,7 @@
+#ifndef GL_LOADER_H
+#define GL_LOADER_H
+
+// Prints the GL version and every entry point gl_loader.c resolved.
+void gl_loader_report();
+
+#endif
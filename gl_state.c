@@ -0,0 +1,70 @@
+#include <glad/glad.h>
+
+#include "gl_state.h"
+
+static GLuint program;
+static GLuint vao;
+static GLuint array_buffer;
+static GLuint texture;
+static int blend = 0;
+
+static unsigned long long elided = 0;
+
+void gl_state_use_program(GLuint new_program) {
+    if (new_program == program) {
+        ++elided;
+        return;
+    }
+    program = new_program;
+    glUseProgram(program);
+}
+
+void gl_state_bind_vao(GLuint new_vao) {
+    if (new_vao == vao) {
+        ++elided;
+        return;
+    }
+    vao = new_vao;
+    glBindVertexArray(vao);
+}
+
+void gl_state_bind_buffer(GLenum target, GLuint buffer) {
+    // Only GL_ARRAY_BUFFER is global state; other targets live in the VAO.
+    if (target != GL_ARRAY_BUFFER) {
+        glBindBuffer(target, buffer);
+        return;
+    }
+
+    if (buffer == array_buffer) {
+        ++elided;
+        return;
+    }
+    array_buffer = buffer;
+    glBindBuffer(target, buffer);
+}
+
+void gl_state_bind_texture(GLuint new_texture) {
+    if (new_texture == texture) {
+        ++elided;
+        return;
+    }
+    texture = new_texture;
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void gl_state_blend(int enabled) {
+    enabled = !!enabled;
+    if (enabled == blend) {
+        ++elided;
+        return;
+    }
+    blend = enabled;
+    if (blend)
+        glEnable(GL_BLEND);
+    else
+        glDisable(GL_BLEND);
+}
+
+unsigned long long gl_state_elided() {
+    return elided;
+}
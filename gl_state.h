@@ -0,0 +1,19 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <glad/glad.h>
+
+// Shadow of the few bits of GL state the game changes. Each setter only
+// calls into the driver when the value actually changes, and counts the
+// calls it skipped.
+
+void gl_state_use_program(GLuint program);
+void gl_state_bind_vao(GLuint vao);
+void gl_state_bind_buffer(GLenum target, GLuint buffer);
+void gl_state_bind_texture(GLuint texture);
+void gl_state_blend(int enabled);
+
+// Total number of driver calls skipped so far.
+unsigned long long gl_state_elided();
+
+#endif
@@ -0,0 +1,229 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <glad/glad.h>
+
+#include "gl_stats.h"
+
+int gl_stats_installed = 0;
+
+static GLFrameStats current;
+static GLFrameStats last;
+static unsigned long long frame_index = 0;
+static FILE *csv = NULL;
+
+// What the driver has bound right now, used to spot redundant calls.
+static GLuint bound_program;
+static GLuint bound_vao;
+static GLuint bound_array_buffer;
+static GLuint bound_texture;
+static GLboolean blend_enabled;
+
+static PFNGLUSEPROGRAMPROC real_glUseProgram;
+static PFNGLBINDVERTEXARRAYPROC real_glBindVertexArray;
+static PFNGLDELETEVERTEXARRAYSPROC real_glDeleteVertexArrays;
+static PFNGLBINDBUFFERPROC real_glBindBuffer;
+static PFNGLDELETEBUFFERSPROC real_glDeleteBuffers;
+static PFNGLBUFFERDATAPROC real_glBufferData;
+static PFNGLBUFFERSUBDATAPROC real_glBufferSubData;
+static PFNGLBINDTEXTUREPROC real_glBindTexture;
+static PFNGLTEXIMAGE2DPROC real_glTexImage2D;
+static PFNGLTEXIMAGE3DPROC real_glTexImage3D;
+static PFNGLTEXSUBIMAGE3DPROC real_glTexSubImage3D;
+static PFNGLVERTEXATTRIBPOINTERPROC real_glVertexAttribPointer;
+static PFNGLENABLEPROC real_glEnable;
+static PFNGLDISABLEPROC real_glDisable;
+static PFNGLDRAWARRAYSPROC real_glDrawArrays;
+
+static void APIENTRY wrap_glUseProgram(GLuint program) {
+    ++current.program_binds;
+    if (program == bound_program)
+        ++current.redundant;
+    bound_program = program;
+    real_glUseProgram(program);
+}
+
+static void APIENTRY wrap_glBindVertexArray(GLuint array) {
+    ++current.vao_binds;
+    if (array == bound_vao)
+        ++current.redundant;
+    bound_vao = array;
+    real_glBindVertexArray(array);
+}
+
+static void APIENTRY wrap_glDeleteVertexArrays(GLsizei n, const GLuint *arrays) {
+    // Deleting the bound VAO unbinds it; the name may be handed out again.
+    for (int i = 0; i < n; ++i)
+        if (arrays[i] == bound_vao)
+            bound_vao = 0;
+    real_glDeleteVertexArrays(n, arrays);
+}
+
+static void APIENTRY wrap_glBindBuffer(GLenum target, GLuint buffer) {
+    ++current.buffer_binds;
+    if (target == GL_ARRAY_BUFFER) {
+        if (buffer == bound_array_buffer)
+            ++current.redundant;
+        bound_array_buffer = buffer;
+    }
+    real_glBindBuffer(target, buffer);
+}
+
+static void APIENTRY wrap_glDeleteBuffers(GLsizei n, const GLuint *buffers) {
+    for (int i = 0; i < n; ++i)
+        if (buffers[i] == bound_array_buffer)
+            bound_array_buffer = 0;
+    real_glDeleteBuffers(n, buffers);
+}
+
+static void APIENTRY wrap_glBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) {
+    ++current.buffer_uploads;
+    current.buffer_bytes += size;
+    real_glBufferData(target, size, data, usage);
+}
+
+static void APIENTRY wrap_glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data) {
+    ++current.buffer_uploads;
+    current.buffer_bytes += size;
+    real_glBufferSubData(target, offset, size, data);
+}
+
+static void APIENTRY wrap_glBindTexture(GLenum target, GLuint texture) {
+    ++current.texture_binds;
+    if (target == GL_TEXTURE_2D) {
+        if (texture == bound_texture)
+            ++current.redundant;
+        bound_texture = texture;
+    }
+    real_glBindTexture(target, texture);
+}
+
+static void count_texture_upload(GLenum format, GLsizei width, GLsizei height, GLsizei depth) {
+    int channels = format == GL_RGBA ? 4 : format == GL_RGB ? 3 : format == GL_RG ? 2 : 1;
+    ++current.texture_uploads;
+    current.texture_bytes += (unsigned long long)width * height * depth * channels;
+}
+
+static void APIENTRY wrap_glTexImage2D(GLenum target, GLint level, GLint internal_format, GLsizei width,
+                                       GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels) {
+    count_texture_upload(format, width, height, 1);
+    real_glTexImage2D(target, level, internal_format, width, height, border, format, type, pixels);
+}
+
+// Texture arrays (the bullet sprites).
+static void APIENTRY wrap_glTexImage3D(GLenum target, GLint level, GLint internal_format, GLsizei width,
+                                       GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type,
+                                       const void *pixels) {
+    count_texture_upload(format, width, height, depth);
+    real_glTexImage3D(target, level, internal_format, width, height, depth, border, format, type, pixels);
+}
+
+static void APIENTRY wrap_glTexSubImage3D(GLenum target, GLint level, GLint x, GLint y, GLint z, GLsizei width,
+                                          GLsizei height, GLsizei depth, GLenum format, GLenum type,
+                                          const void *pixels) {
+    count_texture_upload(format, width, height, depth);
+    real_glTexSubImage3D(target, level, x, y, z, width, height, depth, format, type, pixels);
+}
+
+static void APIENTRY wrap_glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                                                GLsizei stride, const void *pointer) {
+    ++current.attrib_setups;
+    real_glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+}
+
+static void APIENTRY wrap_glEnable(GLenum cap) {
+    ++current.state_changes;
+    if (cap == GL_BLEND) {
+        if (blend_enabled)
+            ++current.redundant;
+        blend_enabled = GL_TRUE;
+    }
+    real_glEnable(cap);
+}
+
+static void APIENTRY wrap_glDisable(GLenum cap) {
+    ++current.state_changes;
+    if (cap == GL_BLEND) {
+        if (!blend_enabled)
+            ++current.redundant;
+        blend_enabled = GL_FALSE;
+    }
+    real_glDisable(cap);
+}
+
+static void APIENTRY wrap_glDrawArrays(GLenum mode, GLint first, GLsizei count) {
+    ++current.draw_calls;
+    current.vertices += count;
+    real_glDrawArrays(mode, first, count);
+}
+
+#define INSTALL(name) \
+    real_##name = glad_##name; \
+    glad_##name = wrap_##name;
+
+void gl_stats_install() {
+    if (gl_stats_installed)
+        return;
+
+    INSTALL(glUseProgram);
+    INSTALL(glBindVertexArray);
+    INSTALL(glDeleteVertexArrays);
+    INSTALL(glBindBuffer);
+    INSTALL(glDeleteBuffers);
+    INSTALL(glBufferData);
+    INSTALL(glBufferSubData);
+    INSTALL(glBindTexture);
+    INSTALL(glTexImage2D);
+    INSTALL(glTexImage3D);
+    INSTALL(glTexSubImage3D);
+    INSTALL(glVertexAttribPointer);
+    INSTALL(glEnable);
+    INSTALL(glDisable);
+    INSTALL(glDrawArrays);
+
+    gl_stats_installed = 1;
+}
+
+void gl_stats_open_csv(const char *path) {
+    csv = fopen(path, "w");
+    if (!csv) {
+        printf("[ERROR] Failed to open GL stats file: %s\n", path);
+        return;
+    }
+
+    fprintf(csv, "frame,draw_calls,vertices,program_binds,vao_binds,buffer_binds,texture_binds,"
+            "attrib_setups,state_changes,redundant,buffer_uploads,buffer_bytes,"
+            "texture_uploads,texture_bytes\n");
+}
+
+void gl_stats_end_frame() {
+    if (!gl_stats_installed)
+        return;
+
+    if (csv) {
+        fprintf(
+            csv, "%llu,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%llu,%u,%llu\n",
+            frame_index,
+            current.draw_calls, current.vertices, current.program_binds,
+            current.vao_binds, current.buffer_binds, current.texture_binds,
+            current.attrib_setups, current.state_changes, current.redundant,
+            current.buffer_uploads, current.buffer_bytes,
+            current.texture_uploads, current.texture_bytes
+        );
+    }
+
+    last = current;
+    memset(&current, 0, sizeof(current));
+    ++frame_index;
+}
+
+const GLFrameStats *gl_stats_last_frame() {
+    return &last;
+}
+
+void gl_stats_close() {
+    if (csv) {
+        fclose(csv);
+        csv = NULL;
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef GL_STATS_H
+#define GL_STATS_H
+
+// Optional interception layer over the glad function pointers. Once
+// installed, the wrapped entry points count what the game sends to the
+// driver each frame, including binds of an object that is already bound.
+
+typedef struct {
+    unsigned draw_calls;
+    unsigned vertices;
+    unsigned program_binds;
+    unsigned vao_binds;
+    unsigned buffer_binds;
+    unsigned texture_binds;
+    unsigned attrib_setups;
+    unsigned state_changes;
+    unsigned redundant;
+    unsigned buffer_uploads;
+    unsigned long long buffer_bytes;
+    unsigned texture_uploads;
+    unsigned long long texture_bytes;
+} GLFrameStats;
+
+extern int gl_stats_installed;
+
+// Swaps the glad pointers for counting wrappers. Call right after
+// gladLoadGLLoader so the shadow state matches the fresh context.
+void gl_stats_install();
+
+// Also append one CSV row per frame to path.
+void gl_stats_open_csv(const char *path);
+
+// Closes the current frame's counters and starts a new frame.
+void gl_stats_end_frame();
+
+// Counters of the last completed frame.
+const GLFrameStats *gl_stats_last_frame();
+
+void gl_stats_close();
+
+#endif
@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "hitch.h"
+#include "gl_stats.h"
+#include "profiler.h"
+
+int hitch_enabled = 0;
+double hitch_budget_ms = 25.0;
+const char *hitch_log_path = "hitches.log";
+
+static FILE *log_file = NULL;
+static unsigned long long frame_index = 0;
+static unsigned long long hitches = 0;
+static int next_slot = 0;
+
+static void write_record(long slot, char *record, int length) {
+    // Pad to the slot size so later writes land on fixed offsets.
+    if (length < 0 || length > HITCH_RECORD_SIZE - 1)
+        length = HITCH_RECORD_SIZE - 1;
+    memset(record + length, ' ', HITCH_RECORD_SIZE - 1 - length);
+    record[HITCH_RECORD_SIZE - 1] = '\n';
+
+    fseek(log_file, slot * HITCH_RECORD_SIZE, SEEK_SET);
+    fwrite(record, 1, HITCH_RECORD_SIZE, log_file);
+}
+
+static void write_header() {
+    char record[HITCH_RECORD_SIZE + 1];
+    int length = snprintf(record, sizeof(record),
+                          "# galaga hitch log: budget %.2f ms, %llu hitches in %llu frames, "
+                          "%d slots of %d bytes, newest in slot %d",
+                          hitch_budget_ms, hitches, frame_index, HITCH_SLOTS, HITCH_RECORD_SIZE,
+                          hitches ? (next_slot + HITCH_SLOTS - 1) % HITCH_SLOTS : -1);
+    write_record(0, record, length);
+}
+
+void hitch_open() {
+    log_file = fopen(hitch_log_path, "w");
+    if (!log_file) {
+        printf("[ERROR] Failed to open hitch log: %s\n", hitch_log_path);
+        hitch_enabled = 0;
+        return;
+    }
+
+    write_header();
+    fflush(log_file);
+}
+
+void hitch_close() {
+    if (!log_file)
+        return;
+
+    write_header();
+    fclose(log_file);
+    log_file = NULL;
+
+    if (hitches)
+        printf("[HITCH] %llu of %llu frames over the %.2f ms budget, see %s\n",
+               hitches, frame_index, hitch_budget_ms, hitch_log_path);
+}
+
+int hitch_check() {
+    ++frame_index;
+    return log_file && profiler_last_frame_ms() > hitch_budget_ms;
+}
+
+void hitch_record(const HitchEntities *entities) {
+    char record[HITCH_RECORD_SIZE + 1];
+    int length = 0;
+
+    char when[32];
+    time_t now = time(NULL);
+    strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", localtime(&now));
+
+#define APPEND(...) \
+    if (length < (int)sizeof(record)) \
+        length += snprintf(record + length, sizeof(record) - length, __VA_ARGS__)
+
+    APPEND("%s frame %llu: %.2f ms |", when, frame_index, profiler_last_frame_ms());
+
+    const double *phases = profiler_last_phases();
+    for (int i = 0; i < NUM_PHASES; ++i)
+        APPEND(" %s %.2f", profiler_phase_name(i), phases[i]);
+
+    if (gl_stats_installed) {
+        const GLFrameStats *gl = gl_stats_last_frame();
+        APPEND(" | GL %u draws %u vertices %u binds %u redundant %u uploads %llu bytes",
+               gl->draw_calls, gl->vertices,
+               gl->program_binds + gl->vao_binds + gl->buffer_binds + gl->texture_binds,
+               gl->redundant, gl->buffer_uploads + gl->texture_uploads,
+               gl->buffer_bytes + gl->texture_bytes);
+    }
+
+    APPEND(" | bullets %d divers %d enemies_alive %d",
+           entities->active_bullets, entities->divers, entities->enemies_alive);
+
+#undef APPEND
+
+    write_record(1 + next_slot, record, length);
+    next_slot = (next_slot + 1) % HITCH_SLOTS;
+    ++hitches;
+
+    write_header();
+    fflush(log_file);
+}
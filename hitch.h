@@ -0,0 +1,35 @@
+#ifndef HITCH_H
+#define HITCH_H
+
+// Hitch detector. Every frame is compared against a time budget; a frame
+// that misses it is written to a log on disk together with its per-phase
+// timings (profiler), GL counters (gl_stats) and entity counts.
+//
+// The log is a ring of HITCH_SLOTS fixed-size text lines after a header
+// line, so it never grows during a long session and a line is complete as
+// soon as it is written. The header names the slot holding the newest
+// hitch; older ones follow it in order, wrapping around.
+
+#define HITCH_SLOTS 256
+#define HITCH_RECORD_SIZE 512
+
+typedef struct {
+    int active_bullets;
+    int divers;
+    int enemies_alive;
+} HitchEntities;
+
+extern int hitch_enabled;
+extern double hitch_budget_ms;
+extern const char *hitch_log_path;
+
+// Opens (and truncates) hitch_log_path.
+void hitch_open();
+void hitch_close();
+
+// Call once per frame after profiler_end_frame. Returns 1 when the frame
+// went over budget and should be passed to hitch_record.
+int hitch_check();
+void hitch_record(const HitchEntities *entities);
+
+#endif
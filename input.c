@@ -0,0 +1,38 @@
+#include "input.h"
+#include "timer.h"
+
+#define QUEUE_SIZE 256
+
+static InputEvent queue[QUEUE_SIZE];
+static int head = 0;
+static int count = 0;
+
+int input_push(InputEvent event) {
+    event.time_ns = timer_now_ns();
+
+    if (event.type == INPUT_CURSOR && count > 0) {
+        InputEvent *last = &queue[(head + count - 1) % QUEUE_SIZE];
+        if (last->type == INPUT_CURSOR) {
+            last->x = event.x;
+            last->y = event.y;
+            return 1;
+        }
+    }
+
+    if (count == QUEUE_SIZE)
+        return 0;
+
+    queue[(head + count) % QUEUE_SIZE] = event;
+    ++count;
+    return 1;
+}
+
+int input_pop(InputEvent *event) {
+    if (count == 0)
+        return 0;
+
+    *event = queue[head];
+    head = (head + 1) % QUEUE_SIZE;
+    --count;
+    return 1;
+}
@@ -0,0 +1,31 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdint.h>
+
+// Input events are queued by the GLFW callbacks with a monotonic timestamp
+// and consumed in order by the simulation at the start of each tick, so a
+// press and release between two ticks are both seen. Consecutive cursor
+// moves are merged into one event that keeps the oldest timestamp.
+
+typedef enum {
+    INPUT_KEY,
+    INPUT_MOUSE_BUTTON,
+    INPUT_CURSOR,
+} InputType;
+
+typedef struct {
+    uint64_t time_ns;
+    InputType type;
+    int code;   // GLFW key or mouse button
+    int action; // GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT
+    double x, y;
+} InputEvent;
+
+// Timestamps the event and queues it. Returns 0 if the queue is full.
+int input_push(InputEvent event);
+
+// Returns 0 when the queue is empty.
+int input_pop(InputEvent *event);
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef NO_INSTRUMENT
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "instrument.h"
+#include "timer.h"
+
+typedef struct ThreadSlots {
+    struct ThreadSlots *next;
+    InstrumentSlot slots[INSTRUMENT_MAX_PROBES];
+} ThreadSlots;
+
+int instrument_enabled = 0;
+__thread InstrumentSlot *instrument_slots = NULL;
+
+static InstrumentProbe *probes[INSTRUMENT_MAX_PROBES];
+static atomic_int num_probes = 0;
+static _Atomic(ThreadSlots*) threads = NULL;
+
+// Ticks are converted to time by comparing them with the monotonic clock
+// over the whole run.
+static uint64_t start_ticks, start_ns;
+
+void instrument_enable() {
+    start_ticks = instrument_ticks();
+    start_ns = timer_now_ns();
+    instrument_enabled = 1;
+}
+
+InstrumentSlot *instrument_register(InstrumentProbe *probe) {
+    if (!instrument_slots) {
+        ThreadSlots *thread = calloc(1, sizeof(ThreadSlots));
+        if (!thread)
+            return NULL;
+
+        ThreadSlots *head = atomic_load(&threads);
+        do {
+            thread->next = head;
+        } while (!atomic_compare_exchange_weak(&threads, &head, thread));
+        instrument_slots = thread->slots;
+    }
+
+    int id = __atomic_load_n(&probe->id, __ATOMIC_ACQUIRE);
+    if (!id) {
+        // Id 0 means unregistered, so ids start at 1.
+        if (atomic_load(&num_probes) >= INSTRUMENT_MAX_PROBES - 1)
+            return NULL;
+
+        int new_id = atomic_fetch_add(&num_probes, 1) + 1;
+        if (new_id >= INSTRUMENT_MAX_PROBES)
+            return NULL;
+        probes[new_id] = probe;
+
+        // Two threads may race on a new probe; the loser's id stays unused.
+        if (__atomic_compare_exchange_n(&probe->id, &id, new_id, 0, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE))
+            id = new_id;
+        else
+            probes[new_id] = NULL;
+    }
+
+    return &instrument_slots[id];
+}
+
+void instrument_report() {
+    if (!instrument_enabled)
+        return;
+
+    double elapsed_ns = (double)(timer_now_ns() - start_ns);
+    double ticks_per_ns = elapsed_ns > 0 ? (instrument_ticks() - start_ticks) / elapsed_ns : 1.0;
+    if (ticks_per_ns <= 0)
+        ticks_per_ns = 1.0;
+
+    int count = atomic_load(&num_probes);
+    if (count > INSTRUMENT_MAX_PROBES - 1)
+        count = INSTRUMENT_MAX_PROBES - 1;
+
+    for (int id = 1; id <= count; ++id) {
+        const InstrumentProbe *probe = probes[id];
+        if (!probe)
+            continue;
+
+        InstrumentSlot sum = { 0 };
+        for (ThreadSlots *thread = atomic_load(&threads); thread; thread = thread->next) {
+            const InstrumentSlot *slot = &thread->slots[id];
+            sum.count += slot->count;
+            sum.total += slot->total;
+            if (slot->max > sum.max)
+                sum.max = slot->max;
+            if (slot->count)
+                sum.last = slot->last;
+        }
+        if (!sum.count)
+            continue;
+
+        switch (probe->kind) {
+        case PROBE_TIMER:
+            printf("[INSTRUMENT] %s: %llu calls, avg %.0f ns, max %.0f ns, total %.2f ms\n",
+                   probe->name, (unsigned long long)sum.count,
+                   sum.total / ticks_per_ns / sum.count, sum.max / ticks_per_ns,
+                   sum.total / ticks_per_ns / 1e6);
+            break;
+        case PROBE_COUNTER:
+            printf("[INSTRUMENT] %s: %llu\n", probe->name, (unsigned long long)sum.total);
+            break;
+        case PROBE_GAUGE:
+            printf("[INSTRUMENT] %s: avg %.1f, max %llu, last %lld\n",
+                   probe->name, (double)sum.total / sum.count,
+                   (unsigned long long)sum.max, (long long)sum.last);
+            break;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+// Probes for hot paths: scoped timers, counters and gauges.
+//
+//     INSTRUMENT_SCOPE("update_enemies");     // times the rest of the block
+//     INSTRUMENT_COUNT("collision_checks", 1);
+//     INSTRUMENT_GAUGE("sprite_vertices", n);
+//
+// Probes stay in normal builds and cost one predictable branch until
+// --instrument turns them on; then a timer is two TSC reads and every probe
+// updates its slot in a thread-local table, with no locks or atomics. The
+// report on exit sums the tables of all threads. Build with -DNO_INSTRUMENT
+// to compile every probe out. Names must be literals.
+
+#ifndef NO_INSTRUMENT
+
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include "timer.h"
+#endif
+
+#define INSTRUMENT_MAX_PROBES 64
+
+typedef enum {
+    PROBE_TIMER,
+    PROBE_COUNTER,
+    PROBE_GAUGE
+} ProbeKind;
+
+// One per call site, 0 until first hit.
+typedef struct {
+    const char *name;
+    ProbeKind kind;
+    int id;
+} InstrumentProbe;
+
+typedef struct {
+    uint64_t count;
+    uint64_t total;
+    uint64_t max;
+    int64_t last;
+} InstrumentSlot;
+
+extern int instrument_enabled;
+extern __thread InstrumentSlot *instrument_slots;
+
+void instrument_enable();
+void instrument_report();
+
+// Slow path: assigns the probe its id and the thread its table.
+InstrumentSlot *instrument_register(InstrumentProbe *probe);
+
+static inline uint64_t instrument_ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return timer_now_ns();
+#endif
+}
+
+static inline InstrumentSlot *instrument_slot(InstrumentProbe *probe) {
+    int id = __atomic_load_n(&probe->id, __ATOMIC_RELAXED);
+    if (__builtin_expect(id && instrument_slots, 1))
+        return &instrument_slots[id];
+    return instrument_register(probe);
+}
+
+static inline void instrument_add(InstrumentProbe *probe, uint64_t value) {
+    InstrumentSlot *slot = instrument_slot(probe);
+    if (!slot)
+        return;
+
+    ++slot->count;
+    slot->total += value;
+    if (value > slot->max)
+        slot->max = value;
+    slot->last = (int64_t)value;
+}
+
+typedef struct {
+    InstrumentProbe *probe;
+    uint64_t start;
+} InstrumentScope;
+
+static inline InstrumentScope instrument_scope_begin(InstrumentProbe *probe) {
+    InstrumentScope scope = { probe, 0 };
+    if (__builtin_expect(instrument_enabled, 0))
+        scope.start = instrument_ticks();
+    return scope;
+}
+
+static inline void instrument_scope_end(InstrumentScope *scope) {
+    if (__builtin_expect(scope->start != 0, 0))
+        instrument_add(scope->probe, instrument_ticks() - scope->start);
+}
+
+#define INSTRUMENT_CONCAT_(a, b) a##b
+#define INSTRUMENT_CONCAT(a, b) INSTRUMENT_CONCAT_(a, b)
+
+#define INSTRUMENT_SCOPE(name) \
+    static InstrumentProbe INSTRUMENT_CONCAT(instrument_probe_, __LINE__) = { name, PROBE_TIMER, 0 }; \
+    InstrumentScope INSTRUMENT_CONCAT(instrument_scope_, __LINE__) \
+        __attribute__((cleanup(instrument_scope_end))) = \
+        instrument_scope_begin(&INSTRUMENT_CONCAT(instrument_probe_, __LINE__))
+
+#define INSTRUMENT_PROBE_(name, kind, value) \
+    do { \
+        static InstrumentProbe probe = { name, kind, 0 }; \
+        if (__builtin_expect(instrument_enabled, 0)) \
+            instrument_add(&probe, (uint64_t)(value)); \
+    } while (0)
+
+#define INSTRUMENT_COUNT(name, n) INSTRUMENT_PROBE_(name, PROBE_COUNTER, n)
+#define INSTRUMENT_GAUGE(name, value) INSTRUMENT_PROBE_(name, PROBE_GAUGE, value)
+
+#else
+
+#define instrument_enabled 0
+#define instrument_enable() ((void)0)
+#define instrument_report() ((void)0)
+
+#define INSTRUMENT_SCOPE(name) ((void)0)
+#define INSTRUMENT_COUNT(name, n) ((void)0)
+#define INSTRUMENT_GAUGE(name, value) ((void)0)
+
+#endif
+
+#endif
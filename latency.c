@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glad/glad.h>
+
+#include "latency.h"
+#include "timer.h"
+
+#define MARKER_SIZE 64
+
+int latency_marker_enabled = 0;
+
+static double samples[LATENCY_WINDOW];
+static int num_samples = 0;
+static int next_sample = 0;
+static unsigned long long frame_index = 0;
+static FILE *log_file = NULL;
+
+void latency_open_log(const char *path) {
+    log_file = fopen(path, "w");
+    if (!log_file) {
+        printf("[ERROR] Failed to open latency log: %s\n", path);
+        return;
+    }
+
+    fprintf(log_file, "frame,input_ns,present_ns,latency_ms\n");
+}
+
+void latency_close() {
+    if (log_file) {
+        fclose(log_file);
+        log_file = NULL;
+    }
+}
+
+void latency_frame_presented(uint64_t input_time_ns) {
+    ++frame_index;
+    if (!input_time_ns)
+        return;
+
+    uint64_t present = timer_now_ns();
+    double latency = (present - input_time_ns) / 1e6;
+
+    samples[next_sample] = latency;
+    next_sample = (next_sample + 1) % LATENCY_WINDOW;
+    if (num_samples < LATENCY_WINDOW)
+        ++num_samples;
+
+    if (log_file)
+        fprintf(log_file, "%llu,%llu,%llu,%.3f\n", frame_index,
+                (unsigned long long)input_time_ns, (unsigned long long)present, latency);
+}
+
+static int compare_doubles(const void *pa, const void *pb) {
+    double a = *(const double*)pa, b = *(const double*)pb;
+    return a < b ? -1 : a > b;
+}
+
+int latency_percentiles(double *p50, double *p95, double *p99, double *max) {
+    if (num_samples == 0)
+        return 0;
+
+    double sorted[LATENCY_WINDOW];
+    memcpy(sorted, samples, num_samples * sizeof(double));
+    qsort(sorted, num_samples, sizeof(double), compare_doubles);
+
+    *p50 = sorted[num_samples * 50 / 100];
+    *p95 = sorted[num_samples * 95 / 100];
+    *p99 = sorted[num_samples * 99 / 100];
+    *max = sorted[num_samples - 1];
+    return num_samples;
+}
+
+void latency_draw_marker() {
+    // The clear color is plain context state; reading it back does not
+    // wait for the GPU.
+    GLfloat clear_color[4];
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, clear_color);
+
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(0, 0, MARKER_SIZE, MARKER_SIZE);
+    glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glClearColor(clear_color[0], clear_color[1], clear_color[2], clear_color[3]);
+    glDisable(GL_SCISSOR_TEST);
+}
@@ -0,0 +1,33 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdint.h>
+
+// Input-to-present latency harness. Every input event is timestamped when
+// GLFW delivers it (input.c), the render list of the first frame that
+// reflects it carries the oldest such timestamp, and the sample is taken
+// when glfwSwapBuffers returns for that frame.
+//
+// The last LATENCY_WINDOW samples give rolling percentiles for the
+// profiler. With a log open every sample is also appended as a CSV row.
+// With the marker on, frames reflecting a click or key press get a white
+// square in the bottom-left corner of the window, so a camera or
+// photodiode can measure the true input-to-photon time externally.
+
+#define LATENCY_WINDOW 512
+
+extern int latency_marker_enabled;
+
+void latency_open_log(const char *path);
+void latency_close();
+
+// input_time_ns of 0 means the frame reflects no input.
+void latency_frame_presented(uint64_t input_time_ns);
+
+// Percentiles over the rolling window. Returns the number of samples in it.
+int latency_percentiles(double *p50, double *p95, double *p99, double *max);
+
+// Draws the marker into the default framebuffer.
+void latency_draw_marker();
+
+#endif
@@ -0,0 +1,278 @@
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "logger.h"
+#include "chrome_trace.h"
+
+typedef enum {
+    ARG_NONE,
+    ARG_INT,
+    ARG_LONG,
+    ARG_LONG_LONG,
+    ARG_SIZE,
+    ARG_DOUBLE,
+    ARG_POINTER
+} ArgClass;
+
+typedef union {
+    long long i;
+    double d;
+    const void *p;
+} LogArg;
+
+typedef struct {
+    const char *format;
+    LogArg args[LOG_MAX_ARGS];
+} LogRecord;
+
+// A cell is free for the producer at position pos when its sequence is
+// pos, and holds a record for the consumer when it is pos + 1.
+typedef struct {
+    atomic_size_t sequence;
+    LogRecord record;
+} LogCell;
+
+static LogCell cells[LOG_CAPACITY];
+static atomic_size_t enqueue_pos;
+static size_t dequeue_pos;
+static atomic_ullong dropped = 0;
+
+static pthread_t thread;
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wakeup = PTHREAD_COND_INITIALIZER;
+static atomic_int running = 0;
+static atomic_int stopping = 0;
+static atomic_int sleeping = 0;
+
+// Classifies the conversion after a '%'. Returns the end of it, and
+// ARG_NONE for "%%" and anything that takes no argument we can store.
+static const char *parse_conversion(const char *p, ArgClass *class) {
+    *class = ARG_NONE;
+
+    while (*p && strchr("-+ #0", *p))
+        ++p;
+    while (*p >= '0' && *p <= '9')
+        ++p;
+    if (*p == '.') {
+        ++p;
+        while (*p >= '0' && *p <= '9')
+            ++p;
+    }
+
+    ArgClass integer = ARG_INT;
+    if (*p == 'h') {
+        p += p[1] == 'h' ? 2 : 1;
+    } else if (*p == 'l') {
+        integer = p[1] == 'l' ? ARG_LONG_LONG : ARG_LONG;
+        p += p[1] == 'l' ? 2 : 1;
+    } else if (*p == 'j') {
+        integer = ARG_LONG_LONG;
+        ++p;
+    } else if (*p == 'z' || *p == 't') {
+        integer = ARG_SIZE;
+        ++p;
+    }
+
+    if (!*p)
+        return p;
+
+    if (strchr("diouxXc", *p))
+        *class = integer;
+    else if (strchr("fFeEgGaA", *p))
+        *class = ARG_DOUBLE;
+    else if (*p == 's' || *p == 'p')
+        *class = ARG_POINTER;
+
+    return p + 1;
+}
+
+static void write_record(const LogRecord *record, FILE *out) {
+    const char *p = record->format;
+    int arg = 0;
+
+    while (*p) {
+        const char *percent = strchr(p, '%');
+        if (!percent) {
+            fputs(p, out);
+            break;
+        }
+        fwrite(p, 1, percent - p, out);
+
+        ArgClass class;
+        const char *end = parse_conversion(percent + 1, &class);
+
+        char spec[32];
+        size_t length = end - percent;
+        if (length >= sizeof(spec))
+            length = sizeof(spec) - 1;
+        memcpy(spec, percent, length);
+        spec[length] = '\0';
+
+        if (class == ARG_NONE || arg == LOG_MAX_ARGS) {
+            if (strcmp(spec, "%%") == 0)
+                fputc('%', out);
+        } else {
+            const LogArg *value = &record->args[arg++];
+            switch (class) {
+            case ARG_INT: fprintf(out, spec, (int)value->i); break;
+            case ARG_LONG: fprintf(out, spec, (long)value->i); break;
+            case ARG_LONG_LONG: fprintf(out, spec, value->i); break;
+            case ARG_SIZE: fprintf(out, spec, (size_t)value->i); break;
+            case ARG_DOUBLE: fprintf(out, spec, value->d); break;
+            case ARG_POINTER: fprintf(out, spec, value->p); break;
+            default: break;
+            }
+        }
+        p = end;
+    }
+}
+
+// Single consumer: returns 0 when the ring is empty.
+static int pop(LogRecord *record) {
+    LogCell *cell = &cells[dequeue_pos & (LOG_CAPACITY - 1)];
+    if (atomic_load_explicit(&cell->sequence, memory_order_acquire) != dequeue_pos + 1)
+        return 0;
+
+    *record = cell->record;
+    atomic_store_explicit(&cell->sequence, dequeue_pos + LOG_CAPACITY, memory_order_release);
+    ++dequeue_pos;
+    return 1;
+}
+
+static int pending() {
+    const LogCell *cell = &cells[dequeue_pos & (LOG_CAPACITY - 1)];
+    return atomic_load(&cell->sequence) == dequeue_pos + 1;
+}
+
+static void *writer_thread(void *unused) {
+    chrome_trace_thread_name("logger");
+
+    for (;;) {
+        LogRecord record;
+        if (pop(&record)) {
+            chrome_trace_begin("log_flush");
+            do {
+                write_record(&record, stdout);
+            } while (pop(&record));
+            fflush(stdout);
+            chrome_trace_end("log_flush");
+            continue;
+        }
+
+        if (atomic_load(&stopping))
+            break;
+
+        // Producers only signal when this flag is set. Setting it and then
+        // checking for records again closes the race with a producer that
+        // looked just before, so the wait needs no timeout; logger_stop
+        // signals too.
+        pthread_mutex_lock(&mutex);
+        atomic_store(&sleeping, 1);
+        if (!pending() && !atomic_load(&stopping))
+            pthread_cond_wait(&wakeup, &mutex);
+        atomic_store(&sleeping, 0);
+        pthread_mutex_unlock(&mutex);
+    }
+
+    return NULL;
+}
+
+void logger_start() {
+    for (size_t i = 0; i < LOG_CAPACITY; ++i)
+        atomic_store(&cells[i].sequence, i);
+    atomic_store(&enqueue_pos, 0);
+    dequeue_pos = 0;
+    atomic_store(&stopping, 0);
+
+    if (pthread_create(&thread, NULL, writer_thread, NULL) != 0) {
+        printf("[ERROR] Failed to start the logger thread, logging synchronously\n");
+        return;
+    }
+    atomic_store(&running, 1);
+}
+
+void logger_stop() {
+    if (!atomic_load(&running))
+        return;
+
+    pthread_mutex_lock(&mutex);
+    atomic_store(&stopping, 1);
+    pthread_cond_signal(&wakeup);
+    pthread_mutex_unlock(&mutex);
+
+    pthread_join(thread, NULL);
+    atomic_store(&running, 0);
+
+    unsigned long long count = atomic_load(&dropped);
+    if (count)
+        printf("[LOG] %llu messages dropped, ring full\n", count);
+}
+
+void log_message(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+
+    if (!atomic_load_explicit(&running, memory_order_relaxed)) {
+        vprintf(format, args);
+        va_end(args);
+        return;
+    }
+
+    size_t pos = atomic_load_explicit(&enqueue_pos, memory_order_relaxed);
+    LogCell *cell;
+    for (;;) {
+        cell = &cells[pos & (LOG_CAPACITY - 1)];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)pos;
+
+        if (difference == 0) {
+            if (atomic_compare_exchange_weak_explicit(&enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (difference < 0) {
+            atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+            va_end(args);
+            return;
+        } else {
+            pos = atomic_load_explicit(&enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    LogRecord *record = &cell->record;
+    record->format = format;
+
+    int arg = 0;
+    for (const char *p = strchr(format, '%'); p && arg < LOG_MAX_ARGS; p = strchr(p, '%')) {
+        ArgClass class;
+        p = parse_conversion(p + 1, &class);
+        switch (class) {
+        case ARG_INT: record->args[arg++].i = va_arg(args, int); break;
+        case ARG_LONG: record->args[arg++].i = va_arg(args, long); break;
+        case ARG_LONG_LONG: record->args[arg++].i = va_arg(args, long long); break;
+        case ARG_SIZE: record->args[arg++].i = (long long)va_arg(args, size_t); break;
+        case ARG_DOUBLE: record->args[arg++].d = va_arg(args, double); break;
+        case ARG_POINTER: record->args[arg++].p = va_arg(args, const void*); break;
+        default: break;
+        }
+    }
+    va_end(args);
+
+    // Sequentially consistent, so this store and the load of sleeping pair
+    // with the writer's store of sleeping and its check for records.
+    atomic_store(&cell->sequence, pos + 1);
+
+    if (atomic_load(&sleeping)) {
+        pthread_mutex_lock(&mutex);
+        pthread_cond_signal(&wakeup);
+        pthread_mutex_unlock(&mutex);
+    }
+}
+
+unsigned long long logger_dropped() {
+    return atomic_load(&dropped);
+}
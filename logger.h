@@ -0,0 +1,28 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+// Asynchronous logger. log_message stores the format pointer and the raw
+// argument values as a fixed-size binary record in a bounded
+// multi-producer ring (a sequence number per cell, claimed with a
+// compare-and-swap); a background thread formats records and writes them
+// to stdout. A producer never blocks: when the ring is full the message is
+// dropped and counted.
+//
+// The format and any %s argument are stored by pointer and formatted
+// later, so both must outlive the logger (literals). At most
+// LOG_MAX_ARGS conversions; '*' widths are not supported. Before
+// logger_start and after logger_stop messages are printed synchronously.
+
+#define LOG_MAX_ARGS 8
+#define LOG_CAPACITY 4096
+
+void logger_start();
+
+// Writes out everything queued and joins the thread.
+void logger_stop();
+
+void log_message(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+unsigned long long logger_dropped();
+
+#endif
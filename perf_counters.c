@@ -0,0 +1,216 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include "perf_counters.h"
+
+enum {
+    EVENT_CYCLES,
+    EVENT_INSTRUCTIONS,
+    EVENT_CACHE_MISSES,
+    EVENT_BRANCH_MISSES,
+    NUM_EVENTS
+};
+
+static const char *region_names[NUM_PERF_REGIONS] = {
+    "update_enemies",
+    "update_bullets",
+    "collision",
+};
+
+typedef struct {
+    uint64_t values[NUM_PERF_REGIONS][NUM_EVENTS];
+    uint64_t ticks;
+} PerfTotals;
+
+int perf_counters_enabled = 0;
+
+static PerfTotals window, run;
+static uint64_t region_start[NUM_PERF_REGIONS][NUM_EVENTS];
+static int region_started[NUM_PERF_REGIONS];
+
+#ifdef __linux__
+
+static const char *event_names[NUM_EVENTS] = {
+    "cycles",
+    "instructions",
+    "cache-misses",
+    "branch-misses",
+};
+
+static const uint64_t event_configs[NUM_EVENTS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+static int group_fd = -1;
+static int fds[NUM_EVENTS] = { -1, -1, -1, -1 };
+
+// Position of each event in a group read, or -1 when it is not counted.
+static int group_index[NUM_EVENTS];
+static int group_size = 0;
+
+static int open_event(int event, int group) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = event_configs[event];
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.disabled = group < 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+void perf_counters_init() {
+    if (!perf_counters_enabled)
+        return;
+
+    int errors[NUM_EVENTS];
+    for (int i = 0; i < NUM_EVENTS; ++i) {
+        group_index[i] = -1;
+        int fd = open_event(i, group_fd);
+        errors[i] = fd < 0 ? errno : 0;
+        if (fd < 0)
+            continue;
+
+        if (group_fd < 0)
+            group_fd = fd;
+        fds[i] = fd;
+        group_index[i] = group_size++;
+    }
+
+    if (group_fd < 0) {
+        printf("[INFO] Hardware performance counters not available: %s%s\n", strerror(errors[0]),
+               errors[0] == EACCES || errors[0] == EPERM ? " (see /proc/sys/kernel/perf_event_paranoid)" : "");
+        perf_counters_enabled = 0;
+        return;
+    }
+
+    for (int i = 0; i < NUM_EVENTS; ++i)
+        if (errors[i])
+            printf("[INFO] perf counter %s not available: %s\n", event_names[i], strerror(errors[i]));
+
+    ioctl(group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void perf_counters_shutdown() {
+    for (int i = 0; i < NUM_EVENTS; ++i) {
+        if (fds[i] >= 0)
+            close(fds[i]);
+        fds[i] = -1;
+    }
+    group_fd = -1;
+    perf_counters_enabled = 0;
+}
+
+static int read_counters(uint64_t *values) {
+    uint64_t data[1 + NUM_EVENTS];
+    if (read(group_fd, data, sizeof(data)) < (ssize_t)sizeof(uint64_t))
+        return 0;
+
+    for (int i = 0; i < NUM_EVENTS; ++i)
+        values[i] = group_index[i] >= 0 ? data[1 + group_index[i]] : 0;
+    return 1;
+}
+
+#else
+
+void perf_counters_init() {
+    if (perf_counters_enabled)
+        printf("[INFO] Hardware performance counters are only supported on Linux\n");
+    perf_counters_enabled = 0;
+}
+
+void perf_counters_shutdown() {
+}
+
+static int read_counters(uint64_t *values) {
+    return 0;
+}
+
+#endif
+
+void perf_counters_begin(PerfRegion region) {
+    if (!perf_counters_enabled)
+        return;
+
+    region_started[region] = read_counters(region_start[region]);
+}
+
+void perf_counters_end(PerfRegion region) {
+    if (!perf_counters_enabled)
+        return;
+
+    uint64_t now[NUM_EVENTS];
+    if (!region_started[region] || !read_counters(now))
+        return;
+    region_started[region] = 0;
+
+    for (int i = 0; i < NUM_EVENTS; ++i) {
+        uint64_t delta = now[i] - region_start[region][i];
+        window.values[region][i] += delta;
+        run.values[region][i] += delta;
+    }
+}
+
+void perf_counters_tick() {
+    if (!perf_counters_enabled)
+        return;
+
+    ++window.ticks;
+    ++run.ticks;
+}
+
+static int counted(int event) {
+#ifdef __linux__
+    return group_index[event] >= 0;
+#else
+    return 0;
+#endif
+}
+
+static void print_count(const PerfTotals *totals, int region, int event, const char *label) {
+    if (counted(event))
+        printf(" %.0f %s", (double)totals->values[region][event] / totals->ticks, label);
+    else
+        printf(" n/a %s", label);
+}
+
+void perf_counters_report(const char *prefix, int whole_run) {
+    if (!perf_counters_enabled)
+        return;
+
+    PerfTotals *totals = whole_run ? &run : &window;
+    if (totals->ticks == 0)
+        return;
+
+    for (int region = 0; region < NUM_PERF_REGIONS; ++region) {
+        const uint64_t *values = totals->values[region];
+        printf("%s %s per tick:", prefix, region_names[region]);
+        print_count(totals, region, EVENT_INSTRUCTIONS, "instructions");
+        print_count(totals, region, EVENT_CYCLES, "cycles");
+        if (counted(EVENT_INSTRUCTIONS) && counted(EVENT_CYCLES) && values[EVENT_CYCLES])
+            printf(", IPC %.2f", (double)values[EVENT_INSTRUCTIONS] / values[EVENT_CYCLES]);
+        printf(",");
+        print_count(totals, region, EVENT_CACHE_MISSES, "cache misses");
+        print_count(totals, region, EVENT_BRANCH_MISSES, "branch misses");
+        printf("\n");
+    }
+
+    if (!whole_run)
+        memset(&window, 0, sizeof(window));
+}
@@ -0,0 +1,39 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+// Hardware performance counters (Linux perf_event_open) around the
+// simulation: cycles, instructions, cache misses and branch misses of the
+// calling thread in user space, per region and averaged per tick. The
+// profiler report prints the last second and the whole run is printed on
+// exit.
+//
+// Each begin/end is one read() of the counter group, so regions should be
+// coarse and are entered once per tick; they do not nest. When the
+// kernel refuses the counters (perf_event_paranoid, containers, no PMU in a
+// VM) a note is printed and everything here becomes a no-op. Counters the
+// CPU lacks are left out of the group and reported as n/a.
+
+typedef enum {
+    PERF_UPDATE_ENEMIES,
+    PERF_UPDATE_BULLETS,
+    PERF_COLLISION,
+    NUM_PERF_REGIONS
+} PerfRegion;
+
+extern int perf_counters_enabled;
+
+// Opens the counters. Clears perf_counters_enabled if none are available.
+void perf_counters_init();
+void perf_counters_shutdown();
+
+void perf_counters_begin(PerfRegion region);
+void perf_counters_end(PerfRegion region);
+
+// Marks the end of a simulation tick.
+void perf_counters_tick();
+
+// Prints per-tick averages since the last call (window) or for the whole
+// run, each line starting with prefix.
+void perf_counters_report(const char *prefix, int whole_run);
+
+#endif
@@ -0,0 +1,161 @@
+#include <stdio.h>
+
+#include "profiler.h"
+#include "chrome_trace.h"
+#include "gl_stats.h"
+#include "gl_state.h"
+#include "latency.h"
+#include "logger.h"
+#include "perf_counters.h"
+#include "render_target.h"
+#include "timer.h"
+
+#define REPORT_INTERVAL_MS 1000.0
+
+int profiler_enabled = 0;
+int profiler_collect = 0;
+
+static const char *phase_names[NUM_PHASES] = {
+    "update_enemies",
+    "update_bullets",
+    "handle_movement",
+    "emit",
+    "sort",
+    "fence_wait",
+    "background",
+    "submit",
+    "swap",
+    "poll",
+};
+
+static double frame_start;
+static double phase_start[NUM_PHASES];
+static double frame_phase[NUM_PHASES];
+
+static double last_frame_time;
+static double last_phase[NUM_PHASES];
+
+// Accumulated since the last report.
+static double window_start = -1;
+static int window_frames;
+static double window_frame_total;
+static double window_frame_max;
+static double window_phase_total[NUM_PHASES];
+static unsigned long long window_elided_start;
+
+const char *profiler_phase_name(Phase phase) {
+    return phase_names[phase];
+}
+
+double profiler_last_frame_ms() {
+    return last_frame_time;
+}
+
+const double *profiler_last_phases() {
+    return last_phase;
+}
+
+void profiler_begin_frame() {
+    chrome_trace_begin("frame");
+    if (!profiler_enabled && !profiler_collect)
+        return;
+
+    frame_start = timer_now_ms();
+    for (int i = 0; i < NUM_PHASES; ++i)
+        frame_phase[i] = 0;
+    if (window_start < 0)
+        window_start = frame_start;
+}
+
+void profiler_phase_begin(Phase phase) {
+    chrome_trace_begin(phase_names[phase]);
+    if (!profiler_enabled && !profiler_collect)
+        return;
+
+    phase_start[phase] = timer_now_ms();
+}
+
+void profiler_phase_end(Phase phase) {
+    chrome_trace_end(phase_names[phase]);
+    if (!profiler_enabled && !profiler_collect)
+        return;
+
+    frame_phase[phase] += timer_now_ms() - phase_start[phase];
+}
+
+static void report(double elapsed) {
+    printf("[PROFILE] %.1f fps, frame %.2f ms avg %.2f ms max |",
+           window_frames * 1000.0 / elapsed,
+           window_frame_total / window_frames,
+           window_frame_max);
+    for (int i = 0; i < NUM_PHASES; ++i)
+        printf(" %s %.2f", phase_names[i], window_phase_total[i] / window_frames);
+    printf("\n");
+
+    unsigned long long elided = gl_state_elided();
+    printf("[PROFILE] GL state cache: %.1f redundant calls elided per frame\n",
+           (double)(elided - window_elided_start) / window_frames);
+    window_elided_start = elided;
+
+    double p50, p95, p99, max;
+    int samples = latency_percentiles(&p50, &p95, &p99, &max);
+    if (samples)
+        printf("[PROFILE] input to present: p50 %.2f p95 %.2f p99 %.2f max %.2f ms (last %d inputs)\n",
+               p50, p95, p99, max, samples);
+
+    perf_counters_report("[PROFILE]", 0);
+
+    unsigned long long dropped = logger_dropped();
+    if (dropped)
+        printf("[PROFILE] logger: %llu messages dropped so far\n", dropped);
+
+    if (render_target_governor)
+        printf("[PROFILE] dynamic resolution: scale %.2f, GPU %.2f ms\n",
+               render_target_scale(), render_target_gpu_ms());
+
+    if (gl_stats_installed) {
+        const GLFrameStats *gl = gl_stats_last_frame();
+        printf("[PROFILE] GL: %u draws, %u vertices, binds %u program %u vao %u buffer %u texture, "
+               "%u attrib setups, %u redundant, %u uploads (%llu bytes)\n",
+               gl->draw_calls, gl->vertices,
+               gl->program_binds, gl->vao_binds, gl->buffer_binds, gl->texture_binds,
+               gl->attrib_setups, gl->redundant,
+               gl->buffer_uploads + gl->texture_uploads, gl->buffer_bytes + gl->texture_bytes);
+    }
+}
+
+void profiler_end_frame() {
+    chrome_trace_end("frame");
+    if (!profiler_enabled && !profiler_collect)
+        return;
+
+    double now = timer_now_ms();
+    double frame_time = now - frame_start;
+
+    last_frame_time = frame_time;
+    for (int i = 0; i < NUM_PHASES; ++i)
+        last_phase[i] = frame_phase[i];
+
+    if (!profiler_enabled)
+        return;
+
+    ++window_frames;
+    window_frame_total += frame_time;
+    if (frame_time > window_frame_max)
+        window_frame_max = frame_time;
+    for (int i = 0; i < NUM_PHASES; ++i)
+        window_phase_total[i] += frame_phase[i];
+
+    double elapsed = now - window_start;
+    if (elapsed < REPORT_INTERVAL_MS)
+        return;
+
+    report(elapsed);
+
+    window_start = now;
+    window_frames = 0;
+    window_frame_total = 0;
+    window_frame_max = 0;
+    for (int i = 0; i < NUM_PHASES; ++i)
+        window_phase_total[i] = 0;
+}
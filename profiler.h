@@ -0,0 +1,40 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Per-frame timing of the main loop phases. When enabled it prints a
+// summary once per second: frame rate, average and worst frame time,
+// average time per phase and the GL counters of the last frame.
+// With only collection on, the timings of the last frame are kept for
+// other consumers (the hitch detector) and nothing is printed.
+// Frames and phases are also recorded in the Chrome trace when it is on.
+
+typedef enum {
+    PHASE_UPDATE_ENEMIES,
+    PHASE_UPDATE_BULLETS,
+    PHASE_MOVEMENT,
+    PHASE_EMIT,
+    PHASE_SORT,
+    PHASE_FENCE,
+    PHASE_BACKGROUND,
+    PHASE_SUBMIT,
+    PHASE_SWAP,
+    PHASE_POLL,
+    NUM_PHASES
+} Phase;
+
+extern int profiler_enabled;
+extern int profiler_collect;
+
+void profiler_begin_frame();
+void profiler_end_frame();
+
+void profiler_phase_begin(Phase phase);
+void profiler_phase_end(Phase phase);
+
+const char *profiler_phase_name(Phase phase);
+
+// Duration of the last completed frame and of each phase within it, in ms.
+double profiler_last_frame_ms();
+const double *profiler_last_phases();
+
+#endif
@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "render_list.h"
+
+#define INITIAL_CAPACITY 1024
+// Keys are sorted on bytes 5 to 7 (depth, texture, program, layer); the
+// bytes below hold the index and zeros.
+#define FIRST_SORT_BYTE 5
+#define SORT_BYTES (8 - FIRST_SORT_BYTE)
+
+void render_list_clear(RenderList *list) {
+    list->count = 0;
+    list->num_textures = 0;
+}
+
+static int grow(RenderList *list) {
+    int capacity = list->capacity ? list->capacity * 2 : INITIAL_CAPACITY;
+    if (capacity > RENDER_LIST_MAX)
+        capacity = RENDER_LIST_MAX;
+    if (capacity == list->capacity)
+        return 0;
+
+    RenderCommand *commands = realloc(list->commands, capacity * sizeof(RenderCommand));
+    if (commands)
+        list->commands = commands;
+    uint64_t *keys = realloc(list->keys, capacity * sizeof(uint64_t));
+    if (keys)
+        list->keys = keys;
+    uint64_t *scratch = realloc(list->scratch, capacity * sizeof(uint64_t));
+    if (scratch)
+        list->scratch = scratch;
+
+    if (!commands || !keys || !scratch)
+        return 0;
+
+    list->capacity = capacity;
+    return 1;
+}
+
+static int texture_slot(RenderList *list, GLuint texture) {
+    // Commands come in runs of the same texture.
+    int last = list->num_textures - 1;
+    if (last >= 0 && list->textures[last] == texture)
+        return last;
+
+    for (int i = 0; i < list->num_textures; ++i)
+        if (list->textures[i] == texture)
+            return i;
+
+    if (list->num_textures == RENDER_TEXTURE_SLOTS)
+        return RENDER_TEXTURE_SLOTS - 1;
+
+    list->textures[list->num_textures] = texture;
+    return list->num_textures++;
+}
+
+int render_list_push(RenderList *list, RenderCommand command) {
+    if (list->count == list->capacity && !grow(list)) {
+        printf("[ERROR] Render list full, dropping commands\n");
+        return 0;
+    }
+
+    int point = (command.flags & RENDER_POINT) != 0;
+    list->keys[list->count] =
+        (uint64_t)(command.layer & 0x3) << 62 |
+        (uint64_t)point << 61 |
+        (uint64_t)texture_slot(list, command.texture) << 56 |
+        (uint64_t)command.depth << 40 |
+        (uint64_t)list->count;
+
+    list->commands[list->count++] = command;
+    return 1;
+}
+
+void render_list_sort(RenderList *list) {
+    if (list->count < 2)
+        return;
+
+    // One read of the keys counts every sorted byte at once and finds the
+    // bits that differ from the first key in at least one key.
+    int offsets[SORT_BYTES][256];
+    memset(offsets, 0, sizeof(offsets));
+    uint64_t first = list->keys[0], varying = 0;
+    for (int i = 0; i < list->count; ++i) {
+        uint64_t key = list->keys[i];
+        varying |= key ^ first;
+        for (int byte = 0; byte < SORT_BYTES; ++byte)
+            ++offsets[byte][(key >> ((FIRST_SORT_BYTE + byte) * 8)) & 0xff];
+    }
+
+    for (int byte = 0; byte < SORT_BYTES; ++byte) {
+        int shift = (FIRST_SORT_BYTE + byte) * 8;
+        if (!((varying >> shift) & 0xff))
+            continue;
+
+        int *offset = offsets[byte];
+        for (int value = 0, total = 0; value < 256; ++value) {
+            int count = offset[value];
+            offset[value] = total;
+            total += count;
+        }
+
+        for (int i = 0; i < list->count; ++i) {
+            uint64_t key = list->keys[i];
+            list->scratch[offset[(key >> shift) & 0xff]++] = key;
+        }
+
+        uint64_t *sorted = list->scratch;
+        list->scratch = list->keys;
+        list->keys = sorted;
+    }
+}
+
+void render_list_free(RenderList *list) {
+    free(list->commands);
+    free(list->keys);
+    free(list->scratch);
+    memset(list, 0, sizeof(*list));
+}
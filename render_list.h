@@ -0,0 +1,85 @@
+#ifndef RENDER_LIST_H
+#define RENDER_LIST_H
+
+#include <stdint.h>
+
+#include <glad/glad.h>
+
+// Draw commands recorded from the world state and consumed by a separate
+// renderer pass. A command is plain data (no pointers into the world, no
+// GL calls), so a list can be built without a GL context, kept around and
+// submitted later.
+//
+// Every command gets a 64-bit sort key, most significant field first:
+//
+//   63..62  layer
+//   61      1 = bullet point pass, 0 = sprite program
+//   60..56  texture slot: textures numbered in order of first use
+//   55..40  depth, back to front
+//   39..24  zero
+//   23..0   index of the command in the list
+//
+// Sorting the keys groups commands by program and texture inside each
+// layer, so the submit loop changes state as rarely as possible. Only the
+// 8-byte keys are moved by the sort; the index finds the command again.
+// Numbering the textures keeps layer, program and texture in one byte, so
+// a sort takes three passes. Past RENDER_TEXTURE_SLOTS textures in a list
+// the rest share the last slot, which only costs texture switches.
+typedef enum {
+    RENDER_LAYER_SHIP,
+    RENDER_LAYER_ENEMIES,
+    RENDER_LAYER_BULLETS,
+    NUM_RENDER_LAYERS
+} RenderLayer;
+
+_Static_assert(NUM_RENDER_LAYERS <= 4, "render layers must fit in two key bits");
+
+#define RENDER_TEXTURE_SLOTS 32
+
+#define RENDER_UPSIDE_DOWN 1 // top of the image at the bottom (enemies)
+#define RENDER_POINT 2       // may be drawn by the bullet point pass
+
+typedef struct {
+    float x, y;
+    float width, height;
+    GLuint texture;
+    unsigned char layer;
+    unsigned char flags;
+    unsigned short depth;
+} RenderCommand;
+
+#define RENDER_LIST_MAX (1 << 24)
+
+typedef struct {
+    RenderCommand *commands;
+    uint64_t *keys;
+    uint64_t *scratch;
+    int count;
+    int capacity;
+    GLuint textures[RENDER_TEXTURE_SLOTS]; // texture of each slot
+    int num_textures;
+    uint64_t input_time_ns; // oldest input the frame reflects, 0 if none
+    int input_pressed;      // a key or button went down for this frame
+} RenderList;
+
+void render_list_clear(RenderList *list);
+
+// Appends the command and its key, growing the list as needed. Returns 0
+// when out of memory or past RENDER_LIST_MAX commands.
+int render_list_push(RenderList *list, RenderCommand command);
+
+// Orders the keys with an LSD radix sort, one byte per pass. The index
+// bytes are never sorted on and bytes that are equal in every key are
+// skipped, so a frame takes at most three passes, after one pass that
+// counts every byte. Commands with equal sort fields keep their
+// recording order.
+void render_list_sort(RenderList *list);
+
+// The i-th command in key order (recording order before sorting).
+static inline const RenderCommand *render_list_get(const RenderList *list, int i) {
+    return &list->commands[list->keys[i] & (RENDER_LIST_MAX - 1)];
+}
+
+void render_list_free(RenderList *list);
+
+#endif
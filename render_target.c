@@ -0,0 +1,180 @@
+#include <stdio.h>
+
+#include <glad/glad.h>
+
+#include "render_target.h"
+
+#define NUM_QUERIES 3
+
+#define MIN_SCALE 0.5f
+#define SCALE_DOWN 0.9f
+#define SCALE_UP 1.05f
+// Only scale back up after this many frames comfortably under budget, so
+// the governor does not oscillate around the threshold.
+#define HEADROOM_FRAMES 30
+#define HEADROOM 0.75
+
+int render_target_enabled = 0;
+int render_target_governor = 0;
+
+static int fixed_width, fixed_height;
+static int window_width, window_height;
+static int target_width, target_height;
+
+static GLuint fbo, color_buffer;
+
+static float scale = 1.0f;
+static double budget_ms;
+static double gpu_ms = 0;
+static int frames_under_budget = 0;
+
+static GLuint queries[NUM_QUERIES];
+static int query_pending[NUM_QUERIES];
+static int query_index = 0;
+
+void render_target_enable(int width, int height) {
+    render_target_enabled = 1;
+    fixed_width = width;
+    fixed_height = height;
+}
+
+void render_target_enable_governor(double budget) {
+    render_target_enabled = 1;
+    render_target_governor = 1;
+    budget_ms = budget;
+}
+
+static void allocate() {
+    target_width = fixed_width > 0 ? fixed_width : window_width;
+    target_height = fixed_height > 0 ? fixed_height : window_height;
+
+    glBindRenderbuffer(GL_RENDERBUFFER, color_buffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, target_width, target_height);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_buffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        printf("[ERROR] Offscreen render target incomplete, drawing to the window\n");
+        render_target_enabled = 0;
+        render_target_governor = 0;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void render_target_init(int width, int height) {
+    window_width = width;
+    window_height = height;
+
+    if (!render_target_enabled)
+        return;
+
+    glGenFramebuffers(1, &fbo);
+    glGenRenderbuffers(1, &color_buffer);
+    allocate();
+
+    if (render_target_governor)
+        glGenQueries(NUM_QUERIES, queries);
+
+    printf("[INFO] Rendering at %dx%d internally%s\n", target_width, target_height,
+           render_target_governor ? " with dynamic resolution" : "");
+}
+
+void render_target_resize(int width, int height) {
+    window_width = width;
+    window_height = height;
+
+    if (render_target_enabled && fbo && fixed_width <= 0)
+        allocate();
+}
+
+static int scaled(int size) {
+    int result = (int)(size * scale + 0.5f);
+    return result > 0 ? result : 1;
+}
+
+void render_target_begin() {
+    if (!render_target_enabled) {
+        glViewport(0, 0, window_width, window_height);
+        return;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, scaled(target_width), scaled(target_height));
+
+    if (render_target_governor) {
+        // Results are read a couple of frames later so the CPU never waits
+        // on the GPU for them. A query that is still not ready by the time
+        // its slot comes around again is simply dropped.
+        query_pending[query_index] = 0;
+        glBeginQuery(GL_TIME_ELAPSED, queries[query_index]);
+    }
+}
+
+static void update_governor() {
+    int oldest = (query_index + 1) % NUM_QUERIES;
+    if (!query_pending[oldest])
+        return;
+
+    GLint available = 0;
+    glGetQueryObjectiv(queries[oldest], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+        return;
+
+    GLuint64 elapsed = 0;
+    glGetQueryObjectui64v(queries[oldest], GL_QUERY_RESULT, &elapsed);
+    query_pending[oldest] = 0;
+
+    gpu_ms = elapsed / 1e6;
+
+    if (gpu_ms > budget_ms) {
+        frames_under_budget = 0;
+        scale *= SCALE_DOWN;
+        if (scale < MIN_SCALE)
+            scale = MIN_SCALE;
+    } else if (gpu_ms < budget_ms * HEADROOM && ++frames_under_budget >= HEADROOM_FRAMES) {
+        frames_under_budget = 0;
+        scale *= SCALE_UP;
+        if (scale > 1.0f)
+            scale = 1.0f;
+    }
+}
+
+void render_target_end() {
+    if (!render_target_enabled)
+        return;
+
+    if (render_target_governor) {
+        glEndQuery(GL_TIME_ELAPSED);
+        query_pending[query_index] = 1;
+        update_governor();
+        query_index = (query_index + 1) % NUM_QUERIES;
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(
+        0, 0, scaled(target_width), scaled(target_height),
+        0, 0, window_width, window_height,
+        GL_COLOR_BUFFER_BIT, GL_LINEAR
+    );
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void render_target_viewport(int *width, int *height) {
+    if (!render_target_enabled) {
+        *width = window_width;
+        *height = window_height;
+        return;
+    }
+
+    *width = scaled(target_width);
+    *height = scaled(target_height);
+}
+
+float render_target_scale() {
+    return scale;
+}
+
+double render_target_gpu_ms() {
+    return gpu_ms;
+}
@@ -0,0 +1,39 @@
+#ifndef RENDER_TARGET_H
+#define RENDER_TARGET_H
+
+// Offscreen rendering at an internal resolution that is independent of
+// the window. The frame is drawn into an FBO and upscaled to the window
+// with one glBlitFramebuffer. With the governor on, the part of the FBO
+// that is actually rendered shrinks while the measured GPU time is over
+// budget and grows back when there is headroom, so fill-rate stays
+// bounded on large displays.
+//
+// Without render_target_enable every call is a no-op apart from keeping
+// the viewport equal to the window.
+
+// width/height of 0 means "same as the window".
+void render_target_enable(int width, int height);
+
+// Turns on dynamic resolution with a GPU frame time budget in ms.
+void render_target_enable_governor(double budget_ms);
+
+void render_target_init(int window_width, int window_height);
+void render_target_resize(int window_width, int window_height);
+
+// Binds the offscreen target and sets the viewport for scene drawing.
+void render_target_begin();
+
+// Upscales the scene to the window and feeds the governor.
+void render_target_end();
+
+extern int render_target_enabled;
+extern int render_target_governor;
+
+// Size of the area the scene is drawn into, in pixels.
+void render_target_viewport(int *width, int *height);
+
+// Current scale of the rendered area and the last measured GPU time.
+float render_target_scale();
+double render_target_gpu_ms();
+
+#endif
@@ -2,6 +2,6 @@
 
 set -xe
 
-clang galaga.c glad.c -lglfw -lGL -lX11 -lpthread -lXrandr -lXi -ldl -lm -O2 -o galaga
-./galaga
+clang galaga.c background.c chrome_trace.c bullet_pass.c frame_pacing.c frame_pipeline.c gl_loader.c shader_cache.c snapshot.c sprite_mesh.c startup_trace.c gl_stats.c gl_state.c hitch.c input.c instrument.c latency.c logger.c perf_counters.c profiler.c render_list.c render_target.c sampler.c vertex_format.c -lglfw -lGL -lX11 -lpthread -lXrandr -lXi -ldl -lm -O2 -rdynamic -o galaga
+./galaga "$@"
 
@@ -0,0 +1,212 @@
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <errno.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "sampler.h"
+
+#define MAX_DEPTH 48
+#define MAX_STACKS 16384
+#define MAX_PROBES 64
+
+// backtrace() inside the handler sees the handler and the kernel's signal
+// trampoline first.
+#define SKIP_FRAMES 2
+
+// Unique (thread, stack) pairs, filled by the signal handler with a
+// compare-and-swap on the hash so no lock is ever taken. The table is only
+// read once sampling has stopped.
+typedef struct {
+    _Atomic uint64_t hash;
+    atomic_uint count;
+    int tid;
+    int depth;
+    void *frames[MAX_DEPTH];
+} Stack;
+
+static Stack stacks[MAX_STACKS];
+static atomic_ulong dropped = 0;
+static const char *output_path = NULL;
+static int main_tid;
+static int running = 0;
+
+static void count_stack(uint64_t hash, int tid, void **frames, int depth) {
+    for (int probe = 0; probe < MAX_PROBES; ++probe) {
+        Stack *stack = &stacks[(hash + probe) & (MAX_STACKS - 1)];
+        uint64_t current = atomic_load(&stack->hash);
+
+        if (current == 0) {
+            if (atomic_compare_exchange_strong(&stack->hash, &current, hash)) {
+                stack->tid = tid;
+                stack->depth = depth;
+                for (int i = 0; i < depth; ++i)
+                    stack->frames[i] = frames[i];
+                atomic_fetch_add(&stack->count, 1);
+                return;
+            }
+        }
+
+        if (current == hash) {
+            atomic_fetch_add(&stack->count, 1);
+            return;
+        }
+    }
+
+    atomic_fetch_add(&dropped, 1);
+}
+
+static void handle_sigprof(int signal, siginfo_t *info, void *context) {
+    int saved_errno = errno;
+
+    void *frames[MAX_DEPTH + SKIP_FRAMES];
+    int depth = backtrace(frames, MAX_DEPTH + SKIP_FRAMES) - SKIP_FRAMES;
+    if (depth > 0) {
+        int tid = (int)syscall(SYS_gettid);
+
+        uint64_t hash = 0xcbf29ce484222325ull ^ (uint64_t)tid;
+        for (int i = 0; i < depth; ++i) {
+            hash ^= (uint64_t)(uintptr_t)frames[SKIP_FRAMES + i];
+            hash *= 0x100000001b3ull;
+        }
+        count_stack(hash ? hash : 1, tid, frames + SKIP_FRAMES, depth);
+    }
+
+    errno = saved_errno;
+}
+
+void sampler_start(const char *path, int hz) {
+    if (hz <= 0)
+        hz = SAMPLER_DEFAULT_HZ;
+
+    // The first backtrace() loads libgcc's unwinder, which allocates and is
+    // not safe inside a signal handler.
+    void *warm[4];
+    backtrace(warm, 4);
+
+    output_path = path;
+    main_tid = (int)syscall(SYS_gettid);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = handle_sigprof;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, NULL) != 0) {
+        printf("[ERROR] Failed to install the SIGPROF handler: %s\n", strerror(errno));
+        return;
+    }
+
+    struct itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = hz >= 1000000 ? 1 : 1000000 / hz;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, NULL) != 0) {
+        printf("[ERROR] Failed to start the sampling timer: %s\n", strerror(errno));
+        signal(SIGPROF, SIG_DFL);
+        return;
+    }
+
+    running = 1;
+}
+
+static void append_symbol(char *line, size_t size, void *address) {
+    size_t length = strlen(line);
+    Dl_info info;
+    int found = dladdr(address, &info);
+
+    if (found && info.dli_sname) {
+        snprintf(line + length, size - length, ";%s", info.dli_sname);
+    } else if (found && info.dli_fname) {
+        const char *name = strrchr(info.dli_fname, '/');
+        snprintf(line + length, size - length, ";[%s]", name ? name + 1 : info.dli_fname);
+    } else {
+        snprintf(line + length, size - length, ";[unknown]");
+    }
+}
+
+typedef struct {
+    char *text;
+    unsigned count;
+} FoldedLine;
+
+static int compare_lines(const void *pa, const void *pb) {
+    return strcmp(((const FoldedLine*)pa)->text, ((const FoldedLine*)pb)->text);
+}
+
+void sampler_stop() {
+    if (!running)
+        return;
+    running = 0;
+
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, NULL);
+    signal(SIGPROF, SIG_IGN);
+
+    static FoldedLine lines[MAX_STACKS];
+    int num_lines = 0;
+    unsigned long long samples = 0;
+
+    for (int i = 0; i < MAX_STACKS; ++i) {
+        Stack *stack = &stacks[i];
+        unsigned count = atomic_load(&stack->count);
+        if (!count)
+            continue;
+
+        size_t size = 64 + MAX_DEPTH * 128;
+        char *text = malloc(size);
+        if (!text)
+            break;
+
+        if (stack->tid == main_tid)
+            snprintf(text, size, "main");
+        else
+            snprintf(text, size, "thread-%d", stack->tid);
+
+        // Root first. The innermost frame is the interrupted instruction,
+        // the others are return addresses that point past their call.
+        for (int frame = stack->depth - 1; frame >= 0; --frame)
+            append_symbol(text, size, (char*)stack->frames[frame] - (frame > 0));
+
+        lines[num_lines++] = (FoldedLine){ text, count };
+        samples += count;
+    }
+
+    // Different addresses in the same functions fold into the same line, so
+    // equal lines are made adjacent and their counts summed.
+    qsort(lines, num_lines, sizeof(FoldedLine), compare_lines);
+
+    FILE *file = fopen(output_path, "w");
+    if (!file) {
+        printf("[ERROR] Failed to write samples: %s\n", output_path);
+    } else {
+        int num_folded = 0;
+        for (int i = 0; i < num_lines;) {
+            unsigned long long total = 0;
+            int j = i;
+            for (; j < num_lines && strcmp(lines[j].text, lines[i].text) == 0; ++j)
+                total += lines[j].count;
+            fprintf(file, "%s %llu\n", lines[i].text, total);
+            ++num_folded;
+            i = j;
+        }
+        fclose(file);
+
+        printf("[SAMPLER] %llu samples in %d stacks written to %s", samples, num_folded, output_path);
+        if (atomic_load(&dropped))
+            printf(" (%lu dropped, stack table full)", (unsigned long)atomic_load(&dropped));
+        printf("\n");
+    }
+
+    for (int i = 0; i < num_lines; ++i)
+        free(lines[i].text);
+}
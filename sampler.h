@@ -0,0 +1,19 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+// Sampling profiler for machines without perf. A SIGPROF interval timer
+// fires for every SAMPLER_DEFAULT_HZ of CPU time used by any thread of the
+// process; the handler captures the interrupted thread's call stack and
+// counts it in a fixed table. On exit the stacks are symbolized with
+// dladdr and written as folded stacks ("thread;caller;callee count"),
+// which flamegraph.pl, speedscope and inferno read directly.
+//
+// Functions of the game itself only get names when it is linked with
+// -rdynamic; static functions show up as their module.
+
+#define SAMPLER_DEFAULT_HZ 1000
+
+void sampler_start(const char *path, int hz);
+void sampler_stop();
+
+#endif
@@ -0,0 +1,211 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "shader_cache.h"
+
+// glad.c is generated for plain GL 3.3 core, so the program binary entry
+// points and enums have to be resolved here.
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+typedef void (APIENTRYP GetProgramBinaryProc)(GLuint program, GLsizei buf_size, GLsizei *length, GLenum *format, void *binary);
+typedef void (APIENTRYP ProgramBinaryProc)(GLuint program, GLenum format, const void *binary, GLsizei length);
+typedef void (APIENTRYP ProgramParameteriProc)(GLuint program, GLenum pname, GLint value);
+
+#define CACHE_MAGIC 0x42504c47u // "GLPB"
+#define CACHE_VERSION 1
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t format;
+    uint32_t length;
+} CacheHeader;
+
+static int initialized = 0;
+static int available = 0;
+
+static GetProgramBinaryProc get_program_binary;
+static ProgramBinaryProc program_binary;
+static ProgramParameteriProc program_parameteri;
+
+static void shader_cache_init() {
+    if (initialized)
+        return;
+    initialized = 1;
+
+    if (!glfwExtensionSupported("GL_ARB_get_program_binary")) {
+        printf("[INFO] GL_ARB_get_program_binary not available, shader cache disabled\n");
+        return;
+    }
+
+    get_program_binary = (GetProgramBinaryProc)glfwGetProcAddress("glGetProgramBinary");
+    program_binary = (ProgramBinaryProc)glfwGetProcAddress("glProgramBinary");
+    program_parameteri = (ProgramParameteriProc)glfwGetProcAddress("glProgramParameteri");
+    if (!get_program_binary || !program_binary || !program_parameteri)
+        return;
+
+    // Drivers may advertise the extension but support zero binary formats
+    // (e.g. Mesa with its own disk cache turned off).
+    GLint num_formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
+    available = num_formats > 0;
+}
+
+static uint64_t fnv1a(uint64_t hash, const char *text) {
+    if (!text)
+        text = "";
+
+    // Hash the terminator too so ("ab", "c") and ("a", "bc") differ.
+    do {
+        hash ^= (unsigned char)*text;
+        hash *= 0x100000001b3ull;
+    } while (*text++);
+
+    return hash;
+}
+
+static uint64_t cache_key(const char *vertex_source, const char *fragment_source) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash = fnv1a(hash, (const char*)glGetString(GL_VENDOR));
+    hash = fnv1a(hash, (const char*)glGetString(GL_RENDERER));
+    hash = fnv1a(hash, (const char*)glGetString(GL_VERSION));
+    hash = fnv1a(hash, vertex_source);
+    hash = fnv1a(hash, fragment_source);
+    return hash;
+}
+
+static int cache_path(uint64_t key, char *path, size_t size, int create_dirs) {
+    char dir[1024];
+    const char *xdg = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+
+    if (xdg && *xdg) {
+        snprintf(dir, sizeof(dir), "%s/galaga", xdg);
+    } else if (home && *home) {
+        snprintf(dir, sizeof(dir), "%s/.cache", home);
+        if (create_dirs)
+            mkdir(dir, 0755);
+        snprintf(dir, sizeof(dir), "%s/.cache/galaga", home);
+    } else {
+        return 0;
+    }
+
+    if (create_dirs)
+        mkdir(dir, 0755);
+
+    snprintf(path, size, "%s/%016llx.bin", dir, (unsigned long long)key);
+    return 1;
+}
+
+int shader_cache_load(GLuint program, const char *vertex_source, const char *fragment_source) {
+    shader_cache_init();
+    if (!available)
+        return 0;
+
+    uint64_t key = cache_key(vertex_source, fragment_source);
+    char path[1100];
+    if (!cache_path(key, path, sizeof(path), 0))
+        return 0;
+
+    FILE *file = fopen(path, "rb");
+    if (!file)
+        return 0;
+
+    CacheHeader header;
+    void *binary = NULL;
+    int success = 0;
+
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        header.magic != CACHE_MAGIC || header.version != CACHE_VERSION ||
+        header.key != key || header.length == 0) {
+        goto done;
+    }
+
+    binary = malloc(header.length);
+    if (!binary || fread(binary, 1, header.length, file) != header.length)
+        goto done;
+
+    program_binary(program, header.format, binary, header.length);
+
+    // The driver is free to reject a binary (new build, different GPU state);
+    // that shows up as a failed link and we just compile from source.
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+        printf("[INFO] Cached shader program rejected by driver, recompiling\n");
+
+done:
+    free(binary);
+    fclose(file);
+    return success;
+}
+
+void shader_cache_prepare(GLuint program) {
+    shader_cache_init();
+    if (!available)
+        return;
+
+    program_parameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+void shader_cache_store(GLuint program, const char *vertex_source, const char *fragment_source) {
+    shader_cache_init();
+    if (!available)
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    void *binary = malloc(length);
+    if (!binary)
+        return;
+
+    GLenum format;
+    GLsizei written = 0;
+    get_program_binary(program, length, &written, &format, binary);
+
+    uint64_t key = cache_key(vertex_source, fragment_source);
+    char path[1100];
+    char tmp_path[1110];
+    if (written <= 0 || !cache_path(key, path, sizeof(path), 1)) {
+        free(binary);
+        return;
+    }
+
+    // Write to a temporary file and rename, so a crash or a second instance
+    // never leaves a truncated entry behind.
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    FILE *file = fopen(tmp_path, "wb");
+    if (!file) {
+        free(binary);
+        return;
+    }
+
+    CacheHeader header = { CACHE_MAGIC, CACHE_VERSION, key, format, (uint32_t)written };
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(binary, 1, written, file) == (size_t)written;
+    ok = fclose(file) == 0 && ok;
+
+    if (ok)
+        rename(tmp_path, path);
+    else
+        remove(tmp_path);
+
+    free(binary);
+}
@@ -0,0 +1,19 @@
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <glad/glad.h>
+
+// On-disk cache of linked program binaries (ARB_get_program_binary).
+// Entries are keyed by GL vendor, renderer, version and the shader sources,
+// so a driver update or an edited .glsl file simply misses the cache.
+
+// Returns 1 if program was restored from the cache and is ready to use.
+int shader_cache_load(GLuint program, const char *vertex_source, const char *fragment_source);
+
+// Must be called before glLinkProgram so the driver keeps the binary around.
+void shader_cache_prepare(GLuint program);
+
+// Writes the binary of a successfully linked program to the cache.
+void shader_cache_store(GLuint program, const char *vertex_source, const char *fragment_source);
+
+#endif
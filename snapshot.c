@@ -0,0 +1,55 @@
+#include <stdio.h>
+
+#include "snapshot.h"
+
+int snapshot_every_tick = 0;
+const char *snapshot_path = "galaga.snap";
+
+static FILE *file = NULL;
+static int failed = 0;
+
+static int snapshot_open() {
+    if (file)
+        return 1;
+    if (failed)
+        return 0;
+
+    file = fopen(snapshot_path, "wb");
+    if (!file) {
+        printf("[ERROR] Failed to open snapshot file: %s\n", snapshot_path);
+        failed = 1;
+        return 0;
+    }
+
+    SnapshotFileHeader header = {
+        SNAPSHOT_MAGIC, SNAPSHOT_VERSION, SNAPSHOT_BYTE_ORDER,
+        sizeof(SnapshotRecord), sizeof(SnapshotEntity)
+    };
+    fwrite(&header, sizeof(header), 1, file);
+    return 1;
+}
+
+int snapshot_write(const SnapshotRecord *record, const SnapshotEntity *entities) {
+    if (!snapshot_open())
+        return 0;
+
+    // Buffered by stdio; a snapshot is at most about 25 KB (512 bullets).
+    fwrite(record, sizeof(SnapshotRecord), 1, file);
+    fwrite(entities, sizeof(SnapshotEntity), record->num_entities, file);
+    return snapshot_ok();
+}
+
+int snapshot_ok() {
+    return file && !ferror(file);
+}
+
+int snapshot_flush() {
+    return file && fflush(file) == 0 && !ferror(file);
+}
+
+void snapshot_close() {
+    if (file) {
+        fclose(file);
+        file = NULL;
+    }
+}
@@ -0,0 +1,92 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdint.h>
+
+// Binary world snapshots, written by the game (D in debug mode, or every
+// tick with --snapshot-every-tick) and read back by snapshot_decode.
+//
+// A file is a SnapshotFileHeader followed by any number of records. Each
+// record is a SnapshotRecord followed by num_entities SnapshotEntity: the
+// spaceship, then every active enemy and bullet. Values are stored in the
+// writer's byte order, which byte_order records. Any change to the structs
+// below must bump SNAPSHOT_VERSION; the header also stores their sizes so a
+// reader can tell a mismatch from a damaged file.
+
+#define SNAPSHOT_MAGIC 0x504e5347u // "GSNP"
+#define SNAPSHOT_RECORD_MAGIC 0x44524353u // "SCRD"
+#define SNAPSHOT_VERSION 2
+#define SNAPSHOT_BYTE_ORDER 0x0102
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t byte_order;
+    uint32_t record_size;
+    uint32_t entity_size;
+} SnapshotFileHeader;
+
+// Record flags.
+#define SNAPSHOT_PAUSED 1
+#define SNAPSHOT_GAME_OVER 2
+#define SNAPSHOT_DEBUG_MODE 4
+
+typedef struct {
+    uint32_t magic;
+    uint32_t num_entities;
+    uint64_t tick;
+    double time;
+    int32_t enemies_alive;
+    int32_t curr_divers;
+    int32_t max_divers;
+    int32_t ticks;
+    uint32_t flags;
+    uint32_t reserved;
+} SnapshotRecord;
+
+typedef enum {
+    SNAPSHOT_SPACESHIP,
+    SNAPSHOT_ENEMY,
+    SNAPSHOT_BULLET
+} SnapshotKind;
+
+// Entity flags.
+#define SNAPSHOT_DIVING 1
+#define SNAPSHOT_FROM_ENEMY 2
+
+typedef struct {
+    uint8_t kind;
+    uint8_t flags;
+    int8_t direction;
+    uint8_t reserved;
+    uint16_t index;
+    uint16_t reserved2;
+    int32_t angle; // grows every tick until the next phase
+    float x, y;
+    float velocity;
+    float width, height;
+    uint32_t sprite;
+    uint32_t reserved3;
+    double last_shoot_time;
+} SnapshotEntity;
+
+_Static_assert(sizeof(SnapshotFileHeader) == 16, "snapshot file header layout changed");
+_Static_assert(sizeof(SnapshotRecord) == 48, "snapshot record layout changed");
+_Static_assert(sizeof(SnapshotEntity) == 48, "snapshot entity layout changed");
+
+extern int snapshot_every_tick;
+extern const char *snapshot_path;
+
+// The file is opened (and truncated) on the first write. Returns 0 if it
+// cannot be written.
+int snapshot_write(const SnapshotRecord *record, const SnapshotEntity *entities);
+
+// Whether the file is open and every write so far succeeded.
+int snapshot_ok();
+
+// Returns 0 if the file is not open or the buffered records could not be
+// written out.
+int snapshot_flush();
+void snapshot_close();
+
+#endif
@@ -0,0 +1,129 @@
+/*
+
+    Offline reader for the world snapshots the game writes (snapshot.h).
+    Prints every record with its entities, or with --csv writes one row per
+    entity, tagged with the tick it belongs to.
+
+    Usage: snapshot_decode [--csv] galaga.snap
+    Build: clang snapshot_decode.c -O2 -o snapshot_decode
+
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "snapshot.h"
+
+static const char *kind_names[] = { "spaceship", "enemy", "bullet" };
+
+static const char *kind_name(int kind) {
+    return kind >= 0 && kind <= SNAPSHOT_BULLET ? kind_names[kind] : "unknown";
+}
+
+static void print_record(const SnapshotRecord *record, const SnapshotEntity *entities) {
+    printf("tick %llu at %.3f s: %d enemies alive, %d/%d divers, ticks %d%s%s%s\n",
+           (unsigned long long)record->tick, record->time,
+           record->enemies_alive, record->curr_divers, record->max_divers, record->ticks,
+           record->flags & SNAPSHOT_PAUSED ? ", paused" : "",
+           record->flags & SNAPSHOT_GAME_OVER ? ", game over" : "",
+           record->flags & SNAPSHOT_DEBUG_MODE ? ", debug mode" : "");
+
+    for (unsigned i = 0; i < record->num_entities; ++i) {
+        const SnapshotEntity *entity = &entities[i];
+        printf("\t%s %d: (%.2f, %.2f) velocity %.2f", kind_name(entity->kind), entity->index,
+               entity->x, entity->y, entity->velocity);
+        if (entity->kind == SNAPSHOT_ENEMY)
+            printf(" direction %d angle %d%s", entity->direction, entity->angle,
+                   entity->flags & SNAPSHOT_DIVING ? " diving" : "");
+        if (entity->kind == SNAPSHOT_BULLET && (entity->flags & SNAPSHOT_FROM_ENEMY))
+            printf(" from enemy");
+        printf("\n");
+    }
+}
+
+static void print_csv(const SnapshotRecord *record, const SnapshotEntity *entities) {
+    for (unsigned i = 0; i < record->num_entities; ++i) {
+        const SnapshotEntity *entity = &entities[i];
+        printf("%llu,%.6f,%d,%d,%u,%s,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%d,%d,%d,%.6f\n",
+               (unsigned long long)record->tick, record->time,
+               record->enemies_alive, record->curr_divers, record->flags,
+               kind_name(entity->kind), entity->index,
+               entity->x, entity->y, entity->velocity, entity->width, entity->height,
+               entity->direction, entity->angle,
+               (entity->flags & SNAPSHOT_DIVING) != 0, (entity->flags & SNAPSHOT_FROM_ENEMY) != 0,
+               entity->last_shoot_time);
+    }
+}
+
+int main(int argc, char **argv) {
+    int csv = 0;
+    const char *path = NULL;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--csv") == 0)
+            csv = 1;
+        else
+            path = argv[i];
+    }
+
+    if (!path) {
+        printf("Usage: %s [--csv] galaga.snap\n", argv[0]);
+        return 1;
+    }
+
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "[ERROR] Failed to open %s\n", path);
+        return 1;
+    }
+
+    SnapshotFileHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != SNAPSHOT_MAGIC) {
+        fprintf(stderr, "[ERROR] %s is not a snapshot file\n", path);
+        fclose(file);
+        return 1;
+    }
+    if (header.byte_order != SNAPSHOT_BYTE_ORDER) {
+        fprintf(stderr, "[ERROR] %s was written on a machine with a different byte order\n", path);
+        fclose(file);
+        return 1;
+    }
+    if (header.version != SNAPSHOT_VERSION) {
+        fprintf(stderr, "[ERROR] %s is snapshot version %d, this decoder reads version %d\n",
+                path, header.version, SNAPSHOT_VERSION);
+        fclose(file);
+        return 1;
+    }
+    if (header.record_size != sizeof(SnapshotRecord) || header.entity_size != sizeof(SnapshotEntity)) {
+        fprintf(stderr, "[ERROR] %s has %u-byte records and %u-byte entities, expected %zu and %zu\n",
+                path, header.record_size, header.entity_size, sizeof(SnapshotRecord), sizeof(SnapshotEntity));
+        fclose(file);
+        return 1;
+    }
+
+    if (csv)
+        printf("tick,time,enemies_alive,curr_divers,flags,kind,index,x,y,velocity,width,height,"
+               "direction,angle,diving,from_enemy,last_shoot_time\n");
+
+    // Enough for the spaceship, every enemy and every bullet of the game.
+    static SnapshotEntity entities[4096];
+    SnapshotRecord record;
+    int records = 0, ok = 1;
+
+    while (fread(&record, sizeof(record), 1, file) == 1) {
+        if (record.magic != SNAPSHOT_RECORD_MAGIC || record.num_entities > 4096 ||
+            fread(entities, sizeof(SnapshotEntity), record.num_entities, file) != record.num_entities) {
+            fprintf(stderr, "[ERROR] %s: record %d is damaged or truncated\n", path, records);
+            ok = 0;
+            break;
+        }
+
+        if (csv)
+            print_csv(&record, entities);
+        else
+            print_record(&record, entities);
+        ++records;
+    }
+
+    fclose(file);
+    return ok ? 0 : 1;
+}
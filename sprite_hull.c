@@ -0,0 +1,215 @@
+/*
+
+    Asset tool: computes a tight convex outline of a sprite's opaque pixels
+    and writes it next to the image as <name>.hull, which the game draws as
+    a triangle fan instead of the full quad. Fully transparent corners are
+    then never rasterized, so fewer fragments are blended.
+
+    The outline always contains every pixel with alpha above the threshold.
+    It is reduced to at most MAX_VERTICES by merging edges outwards, picking
+    each time the merge that adds the least area.
+
+    Usage: sprite_hull image.png [image.png ...]
+    Build: gen_sprite_meshes.sh
+
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#define ALPHA_THRESHOLD 8
+#define MAX_VERTICES 8
+#define MAX_POINTS 8192
+
+typedef struct {
+    double x, y;
+} Point;
+
+static double cross(Point o, Point a, Point b) {
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+static int compare_points(const void *pa, const void *pb) {
+    const Point *a = pa, *b = pb;
+    if (a->x != b->x)
+        return a->x < b->x ? -1 : 1;
+    if (a->y != b->y)
+        return a->y < b->y ? -1 : 1;
+    return 0;
+}
+
+// Andrew's monotone chain. Returns the hull in counter-clockwise order
+// without collinear points.
+static int convex_hull(Point *points, int n, Point *hull) {
+    qsort(points, n, sizeof(Point), compare_points);
+
+    int k = 0;
+    for (int i = 0; i < n; ++i) {
+        while (k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0)
+            --k;
+        hull[k++] = points[i];
+    }
+    for (int i = n - 2, lower = k + 1; i >= 0; --i) {
+        while (k >= lower && cross(hull[k - 2], hull[k - 1], points[i]) <= 0)
+            --k;
+        hull[k++] = points[i];
+    }
+
+    return k - 1;
+}
+
+static double polygon_area(const Point *polygon, int n) {
+    double area = 0;
+    for (int i = 0; i < n; ++i) {
+        Point a = polygon[i], b = polygon[(i + 1) % n];
+        area += a.x * b.y - b.x * a.y;
+    }
+    return area / 2.0;
+}
+
+// Replaces edge (i, i+1) by extending its neighbouring edges until they
+// meet. Returns the added area, or -1 when the edges diverge or the new
+// corner would leave the image.
+static double merge_cost(const Point *polygon, int n, int i, double width, double height, Point *corner) {
+    Point a0 = polygon[(i + n - 1) % n], a1 = polygon[i];
+    Point b0 = polygon[(i + 2) % n], b1 = polygon[(i + 1) % n];
+
+    double dax = a1.x - a0.x, day = a1.y - a0.y;
+    double dbx = b1.x - b0.x, dby = b1.y - b0.y;
+    double denominator = dax * dby - day * dbx;
+    if (denominator == 0)
+        return -1;
+
+    // a1 + t * da == b1 + s * db, both rays pointing away from the edge.
+    double t = ((b1.x - a1.x) * dby - (b1.y - a1.y) * dbx) / denominator;
+    double s = ((b1.x - a1.x) * day - (b1.y - a1.y) * dax) / denominator;
+    if (t < 0 || s < 0)
+        return -1;
+
+    corner->x = a1.x + t * dax;
+    corner->y = a1.y + t * day;
+    if (corner->x < -1e-9 || corner->y < -1e-9 || corner->x > width + 1e-9 || corner->y > height + 1e-9)
+        return -1;
+
+    return fabs(cross(a1, b1, *corner)) / 2.0;
+}
+
+static int reduce(Point *polygon, int n, double width, double height) {
+    while (n > MAX_VERTICES) {
+        int best = -1;
+        double best_cost = 0;
+        Point best_corner;
+
+        for (int i = 0; i < n; ++i) {
+            Point corner;
+            double cost = merge_cost(polygon, n, i, width, height, &corner);
+            if (cost >= 0 && (best < 0 || cost < best_cost)) {
+                best = i;
+                best_cost = cost;
+                best_corner = corner;
+            }
+        }
+
+        if (best < 0)
+            return 0;
+
+        // Vertex best becomes the new corner, vertex best + 1 goes away.
+        int removed = (best + 1) % n;
+        polygon[best] = best_corner;
+        memmove(&polygon[removed], &polygon[removed + 1], (n - removed - 1) * sizeof(Point));
+        --n;
+    }
+
+    return n;
+}
+
+static int process(const char *path) {
+    int width, height, components;
+    unsigned char *data = stbi_load(path, &width, &height, &components, 4);
+    if (!data) {
+        printf("[ERROR] Failed to load %s\n", path);
+        return 0;
+    }
+
+    // The left and right edge of every opaque row is enough for a convex
+    // hull. Pixel corners are used so whole texels stay inside.
+    static Point points[MAX_POINTS];
+    static Point hull[MAX_POINTS + 1];
+    int n = 0;
+    for (int y = 0; y < height && n + 4 <= MAX_POINTS; ++y) {
+        int left = -1, right = -1;
+        for (int x = 0; x < width; ++x) {
+            if (data[(y * width + x) * 4 + 3] > ALPHA_THRESHOLD) {
+                if (left < 0)
+                    left = x;
+                right = x;
+            }
+        }
+        if (left < 0)
+            continue;
+
+        points[n++] = (Point){ left, y };
+        points[n++] = (Point){ left, y + 1 };
+        points[n++] = (Point){ right + 1, y };
+        points[n++] = (Point){ right + 1, y + 1 };
+    }
+    stbi_image_free(data);
+
+    int count = 0;
+    if (n >= 3) {
+        count = convex_hull(points, n, hull);
+        count = reduce(hull, count, width, height);
+    }
+
+    if (count < 3) {
+        // Nothing to trim (or nothing opaque at all): fall back to the quad.
+        hull[0] = (Point){ 0, 0 };
+        hull[1] = (Point){ width, 0 };
+        hull[2] = (Point){ width, height };
+        hull[3] = (Point){ 0, height };
+        count = 4;
+    }
+
+    double coverage = fabs(polygon_area(hull, count)) / ((double)width * height);
+
+    char out_path[1024];
+    snprintf(out_path, sizeof(out_path), "%s", path);
+    char *extension = strrchr(out_path, '.');
+    if (!extension || strchr(extension, '/'))
+        extension = out_path + strlen(out_path);
+    snprintf(extension, sizeof(out_path) - (extension - out_path), ".hull");
+
+    FILE *file = fopen(out_path, "w");
+    if (!file) {
+        printf("[ERROR] Failed to write %s\n", out_path);
+        return 0;
+    }
+
+    fprintf(file, "# sprite_hull: %s %dx%d, %d vertices, %.1f%% of the quad\n",
+            path, width, height, count, coverage * 100.0);
+    fprintf(file, "%d\n", count);
+    for (int i = 0; i < count; ++i)
+        fprintf(file, "%f %f\n", hull[i].x / width, hull[i].y / height);
+    fclose(file);
+
+    printf("%s: %d vertices, %.1f%% of the quad\n", out_path, count, coverage * 100.0);
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        printf("Usage: %s image.png [image.png ...]\n", argv[0]);
+        return 1;
+    }
+
+    int ok = 1;
+    for (int i = 1; i < argc; ++i)
+        ok = process(argv[i]) && ok;
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "sprite_mesh.h"
+
+#define MAX_SPRITE_MESHES 32
+
+// A hull vertex costs as much as a quad corner (8 bytes), so a hull with
+// twice the corners only pays off when it trims a good part of the
+// quad's fill; below this fraction the sprite keeps the quad.
+#define MIN_HULL_SAVING 0.25f
+
+int sprite_meshes_enabled = 1;
+
+static SpriteMesh meshes[MAX_SPRITE_MESHES];
+static int num_meshes = 0;
+
+static const SpriteMesh quad = {
+    .count = 4,
+    .uv = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } },
+};
+
+static int read_hull(const char *image_path, SpriteMesh *mesh) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s", image_path);
+    char *extension = strrchr(path, '.');
+    if (!extension || strchr(extension, '/'))
+        extension = path + strlen(path);
+    snprintf(extension, sizeof(path) - (extension - path), ".hull");
+
+    FILE *file = fopen(path, "r");
+    if (!file)
+        return 0;
+
+    char line[256];
+    int count = 0;
+    while (fgets(line, sizeof(line), file)) {
+        if (line[0] != '#' && sscanf(line, "%d", &count) == 1)
+            break;
+    }
+
+    int success = count >= 3 && count <= MAX_MESH_VERTICES;
+    for (int i = 0; success && i < count; ++i)
+        success = fscanf(file, "%f %f", &mesh->uv[i][0], &mesh->uv[i][1]) == 2;
+
+    fclose(file);
+
+    if (!success) {
+        printf("[ERROR] Invalid sprite outline: %s\n", path);
+        return 0;
+    }
+
+    mesh->count = count;
+    return 1;
+}
+
+// Fraction of the quad the outline covers (shoelace formula).
+static float hull_area(const SpriteMesh *mesh) {
+    float area = 0.0f;
+    for (int i = 0; i < mesh->count; ++i) {
+        const float *a = mesh->uv[i];
+        const float *b = mesh->uv[(i + 1) % mesh->count];
+        area += a[0] * b[1] - b[0] * a[1];
+    }
+    return area < 0.0f ? -area / 2.0f : area / 2.0f;
+}
+
+void sprite_mesh_load(GLuint texture, const char *image_path) {
+    if (!sprite_meshes_enabled)
+        return;
+
+    // A restart reloads every texture under a new name; reuse the slot.
+    SpriteMesh *mesh = NULL;
+    for (int i = 0; i < num_meshes; ++i)
+        if (strcmp(meshes[i].path, image_path) == 0)
+            mesh = &meshes[i];
+
+    if (!mesh) {
+        if (num_meshes == MAX_SPRITE_MESHES)
+            return;
+        mesh = &meshes[num_meshes];
+        if (!read_hull(image_path, mesh))
+            return;
+        if (mesh->count > quad.count && hull_area(mesh) > 1.0f - MIN_HULL_SAVING)
+            return;
+        snprintf(mesh->path, sizeof(mesh->path), "%s", image_path);
+        ++num_meshes;
+    }
+
+    mesh->texture = texture;
+}
+
+const SpriteMesh *sprite_mesh_get(GLuint texture) {
+    static const SpriteMesh *last = NULL;
+    if (last && last->texture == texture)
+        return last;
+
+    for (int i = 0; i < num_meshes; ++i) {
+        if (meshes[i].texture == texture) {
+            last = &meshes[i];
+            return last;
+        }
+    }
+
+    return &quad;
+}
@@ -0,0 +1,29 @@
+#ifndef SPRITE_MESH_H
+#define SPRITE_MESH_H
+
+#include <glad/glad.h>
+
+// Alpha-trimmed outlines produced by sprite_hull.c. Each outline is a
+// convex polygon in texture coordinates (u right, v down from the top of
+// the image), drawn as a triangle fan. An outline that trims too little of
+// the quad to pay for its extra vertices is ignored.
+
+#define MAX_MESH_VERTICES 16
+
+typedef struct {
+    GLuint texture;
+    char path[64];
+    int count;
+    float uv[MAX_MESH_VERTICES][2];
+} SpriteMesh;
+
+extern int sprite_meshes_enabled;
+
+// Loads <image without extension>.hull for a freshly loaded texture.
+// Sprites without a worthwhile outline keep drawing as a quad.
+void sprite_mesh_load(GLuint texture, const char *image_path);
+
+// Never returns NULL: unknown textures get the full quad.
+const SpriteMesh *sprite_mesh_get(GLuint texture);
+
+#endif
@@ -0,0 +1,48 @@
+#version 330 core
+
+// Procedural backdrop: three layers of stars on a hashed grid, each layer
+// scrolling down at its own speed for parallax. No textures are sampled.
+
+in vec2 TexCoord;
+
+out vec4 FragColor;
+
+uniform float time;
+uniform vec2 resolution;
+
+float hash(vec2 p) {
+    p = fract(p * vec2(123.34, 456.21));
+    p += dot(p, p + 45.32);
+    return fract(p.x * p.y);
+}
+
+// cell_size in pixels, speed in pixels per second, density is the chance
+// that a cell holds a star.
+vec3 star_layer(vec2 pixel, float cell_size, float speed, float density, float brightness) {
+    vec2 p = (pixel + vec2(0.0, time * speed)) / cell_size;
+    vec2 cell = floor(p);
+
+    float h = hash(cell);
+    if (h > density)
+        return vec3(0.0);
+
+    vec2 star = vec2(hash(cell + 17.0), hash(cell + 31.0)) * 0.8 + 0.1;
+    float dist = length((fract(p) - star) * cell_size);
+    float radius = 0.8 + 1.6 * hash(cell + 5.0) * brightness;
+    float twinkle = 0.75 + 0.25 * sin(time * 3.0 + h * 100.0);
+
+    vec3 tint = mix(vec3(0.7, 0.8, 1.0), vec3(1.0, 0.9, 0.7), hash(cell + 9.0));
+    return tint * brightness * twinkle * (1.0 - smoothstep(0.0, radius, dist));
+}
+
+void main() {
+    // TexCoord.y is flipped on the background quad; work bottom-up in pixels.
+    vec2 pixel = vec2(TexCoord.x, 1.0 - TexCoord.y) * resolution;
+
+    vec3 color = vec3(0.0, 0.0, 0.03);
+    color += star_layer(pixel, 90.0, 12.0, 0.30, 0.45);
+    color += star_layer(pixel, 60.0, 30.0, 0.20, 0.70);
+    color += star_layer(pixel, 40.0, 70.0, 0.10, 1.00);
+
+    FragColor = vec4(color, 1.0);
+}
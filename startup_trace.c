@@ -0,0 +1,69 @@
+#include <stdio.h>
+
+#include "startup_trace.h"
+#include "timer.h"
+
+#define MAX_STAGES 64
+
+typedef struct {
+    const char *name;
+    double time;
+} Stage;
+
+static int enabled = 0;
+static int finished = 0;
+static const char *report_path = NULL;
+
+static double start_time;
+static Stage stages[MAX_STAGES];
+static int num_stages = 0;
+
+void startup_trace_enable(const char *output_path) {
+    enabled = 1;
+    finished = 0;
+    num_stages = 0;
+    report_path = output_path;
+    start_time = timer_now_ms();
+}
+
+void startup_trace_mark(const char *stage) {
+    if (!enabled || finished || num_stages >= MAX_STAGES)
+        return;
+
+    stages[num_stages].name = stage;
+    stages[num_stages].time = timer_now_ms();
+    ++num_stages;
+}
+
+void startup_trace_first_frame() {
+    if (!enabled || finished)
+        return;
+
+    startup_trace_mark("first glfwSwapBuffers");
+    finished = 1;
+
+    FILE *out = stdout;
+    if (report_path) {
+        out = fopen(report_path, "w");
+        if (!out) {
+            printf("[ERROR] Failed to open startup report: %s\n", report_path);
+            return;
+        }
+    }
+
+    fprintf(out, "[STARTUP] %-32s %10s %10s\n", "stage", "ms", "at ms");
+    double previous = start_time;
+    for (int i = 0; i < num_stages; ++i) {
+        fprintf(
+            out, "[STARTUP] %-32s %10.2f %10.2f\n",
+            stages[i].name,
+            stages[i].time - previous,
+            stages[i].time - start_time
+        );
+        previous = stages[i].time;
+    }
+    fprintf(out, "[STARTUP] time to first frame: %.2f ms\n", previous - start_time);
+
+    if (out != stdout)
+        fclose(out);
+}
@@ -0,0 +1,18 @@
+#ifndef STARTUP_TRACE_H
+#define STARTUP_TRACE_H
+
+// Launch timeline: each mark closes the stage that started at the previous
+// mark. The report lists every stage and the time to the first presented
+// frame, either on stdout or into a file.
+
+// Enables tracing. output_path may be NULL to print the report to stdout.
+void startup_trace_enable(const char *output_path);
+
+// Records the end of a stage. The name must outlive the trace (literals).
+// Does nothing when tracing is off or the report was already written.
+void startup_trace_mark(const char *stage);
+
+// Marks the first glfwSwapBuffers and writes the report (once).
+void startup_trace_first_frame();
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdint.h>
+#include <time.h>
+
+// Monotonic clock shared by the instrumentation modules. Unlike glfwGetTime
+// it works before glfwInit and without a window.
+
+static inline uint64_t timer_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline double timer_now_ms() {
+    return timer_now_ns() / 1e6;
+}
+
+#endif
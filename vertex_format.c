@@ -0,0 +1,12 @@
+#include <stddef.h>
+
+#include <glad/glad.h>
+
+#include "vertex_format.h"
+
+void vertex_format_sprite_layout() {
+    glVertexAttribPointer(0, 2, GL_SHORT, GL_TRUE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, x));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, u));
+    glEnableVertexAttribArray(1);
+}
@@ -1,13 +1,13 @@
 #version 330 core
 
-in vec3 aPos;
-in vec2 aTexCoord; // Add this line
+layout (location = 0) in vec2 aPos; // normalized shorts, see vertex_format.h
+layout (location = 1) in vec2 aTexCoord;
 
 out vec2 TexCoord; // Add this line
 
 uniform mat4 transform;
 
 void main() {
-    gl_Position = transform * vec4(aPos, 1.0f);
+    gl_Position = transform * vec4(aPos, 0.0f, 1.0f);
     TexCoord = aTexCoord; // Pass texture coordinates to fragment shader
 }